@@ -1,228 +1,357 @@
 #include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
+
+#include "myron_columns.h"
+#include "myron_lexer.h"
+#include "myron_writer.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+// A growable output buffer. The memory is kept when the buffer is cleared,
+// so that a buffer can be reused without allocating again.
+struct Buffer {
+    char *data;
+    size_t size;
+    size_t capacity;
+};
 
-int is_alpha(int byte) {
-    return ('a' <= byte && byte <= 'z') || ('A' <= byte && byte <= 'Z');
-}
+void buffer_reserve(struct Buffer *buffer, size_t size) {
+    assert(buffer != NULL);
 
-int is_digit(int byte) {
-    return '0' <= byte && byte <= '9';
-}
+    if (buffer->size + size <= buffer->capacity) {
+        return;
+    }
 
-int is_number(int byte) {
-    return is_digit(byte) || byte == '_';
+    size_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->size + size) {
+        capacity *= 2;
+    }
+
+    buffer->data = realloc(buffer->data, capacity);
+    assert(buffer->data != NULL);
+    buffer->capacity = capacity;
 }
 
-int is_identifier(int byte) {
-    return is_alpha(byte) || is_number(byte) || byte == '_';
+void buffer_write(struct Buffer *buffer, const void *data, size_t size) {
+    buffer_reserve(buffer, size);
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
 }
 
-int is_whitespace(int byte) {
-    return byte == ' ' || byte == '\t';
+void buffer_putc(struct Buffer *buffer, char byte) {
+    buffer_reserve(buffer, 1);
+    buffer->data[buffer->size++] = byte;
 }
 
-enum TokenType {
-    TT_UNDEFN,
-    TT_IDENTI,
-    TT_WSPACE,
-    TT_NEWLIN,
-    TT_STRING,
-    TT_NUMBER,
-    TT_LPAREN,
-    TT_RPAREN,
-    TT_LBRACE,
-    TT_RBRACE,
-    TT_LBRACK,
-    TT_RBRACK,
-};
+void buffer_puts(struct Buffer *buffer, const char *string) {
+    buffer_write(buffer, string, strlen(string));
+}
 
-char* token_type_to_string(enum TokenType token_type) {
-    switch (token_type) {
-        case TT_UNDEFN:
-            return "TT_UNDEFN";
-        case TT_IDENTI:
-            return "TT_IDENTI";
-        case TT_WSPACE:
-            return "TT_WSPACE";
-        case TT_NEWLIN:
-            return "TT_NEWLIN";
-        case TT_STRING:
-            return "TT_STRING";
-        case TT_NUMBER:
-            return "TT_NUMBER";
-        case TT_LPAREN:
-            return "TT_LPAREN";
-        case TT_RPAREN:
-            return "TT_RPAREN";
-        case TT_LBRACE:
-            return "TT_LBRACE";
-        case TT_RBRACE:
-            return "TT_RBRACE";
-        case TT_LBRACK:
-            return "TT_LBRACK";
-        case TT_RBRACK:
-            return "TT_RBRACK";
-    }
-    return NULL;
+void buffer_clear(struct Buffer *buffer) {
+    buffer->size = 0;
 }
 
-struct Token {
-    enum TokenType type;
-    size_t start, end;
-    size_t line, col;
-};
+void buffer_free(struct Buffer *buffer) {
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
 
-void slice_write(FILE *src, FILE *dst, size_t start, size_t end) {
+void slice_write(struct Source *src, struct Buffer *dst, size_t start, size_t end) {
     assert(src != NULL);
     assert(dst != NULL);
     assert(start < end);
 
-    // Seek out the position from which to start reading.
-    fseek(src, start, SEEK_SET);
-
-    for (size_t i = 0; i < end - start; i += 1) {
-        int byte = getc(src);
-        putc(byte, dst);
-    }
+    buffer_write(dst, src->data + start, end - start);
 }
 
-int slice_equals(FILE *file, size_t start, size_t end, const char *comparison) {
-    assert(file != NULL);
+int slice_equals(struct Source *src, size_t start, size_t end, const char *comparison) {
+    assert(src != NULL);
     assert(start < end);
     assert(comparison != NULL);
 
-    // Seek out the position from which to start reading.
-    fseek(file, start, SEEK_SET);
+    return strlen(comparison) == end - start && !memcmp(src->data + start, comparison, end - start);
+}
+
+// Copies the slice into a newly allocated, NUL terminated string.
+// The caller is responsible for freeing the returned string.
+char *slice_read(struct Source *src, size_t start, size_t end) {
+    assert(src != NULL);
+    assert(start <= end);
+
+    char *string = malloc(end - start + 1);
+    assert(string != NULL);
 
-    for (size_t i = 0; i < end - start; i += 1) {
-        int byte = getc(file);
-        if (byte != comparison[i]) {
-            return 0;
+    memcpy(string, src->data + start, end - start);
+    string[end - start] = '\0';
+
+    return string;
+}
+
+// Copies a string slice, quotes included, as a JSON string. The escapes of myron
+// are the same as in JSON, but control characters may appear as is in myron strings
+// and have to be escaped, just like write_json_string does for the column files.
+void slice_write_json_string(struct Source *src, struct Buffer *dst, size_t start, size_t end) {
+    assert(src != NULL);
+    assert(dst != NULL);
+    assert(start < end);
+
+    size_t copied = start;
+    for (size_t i = start; i < end; i += 1) {
+        unsigned char byte = src->data[i];
+        if (byte >= 0x20) {
+            continue;
+        }
+
+        buffer_write(dst, src->data + copied, i - copied);
+        copied = i + 1;
+
+        switch (byte) {
+            case '\n':
+                buffer_puts(dst, "\\n");
+                break;
+            case '\r':
+                buffer_puts(dst, "\\r");
+                break;
+            case '\t':
+                buffer_puts(dst, "\\t");
+                break;
+            default: {
+                char escape[7] = {'\\', 'u', '0', '0', "0123456789abcdef"[byte >> 4], "0123456789abcdef"[byte & 15], '\0'};
+                buffer_puts(dst, escape);
+            } break;
         }
     }
+    buffer_write(dst, src->data + copied, end - copied);
+}
 
-    return 1;
+// The parser reads the tokens of the source through a reader, either directly
+// or from the lexer thread of a pipeline. The tokens are counted for --stats.
+struct Reader {
+    struct Source src;
+    struct Pipeline *pipeline; // NULL => tokens are read directly
+    size_t token_count;
+};
+
+void reader_init(struct Reader *reader, const char *data, size_t size) {
+    assert(reader != NULL);
+
+    source_init(&reader->src, data, size);
+    reader->pipeline = NULL;
+    reader->token_count = 0;
 }
 
-int token_next(FILE *file, struct Token *token) {
-    assert(file != NULL);
-    assert(token != NULL);
+#ifndef _WIN32
 
-    // TODO: How do we reset these if needed?
-    static size_t line = 1;
-    static size_t col = 1;
+// PIPELINE
+//
+// Lexing and parsing can run on separate threads. The lexer thread fills batches
+// of tokens into a ring, and the parser thread reads the tokens from the ring.
+// There is a single producer and a single consumer, so the ring only needs
+// two counters: the batches published by the lexer and the batches released by the parser.
+// Whitespace and newlines are skipped by the parser anyway, so they are never passed on.
 
-    // Set the starting position of the token.
-    // This starts from 0 (just like an index).
-    token->start = ftell(file);
-    token->line = line;
-    token->col = col;
+#define PIPELINE_BATCH_COUNT 64
+#define PIPELINE_DEFAULT_BATCH_SIZE 256
+#define PIPELINE_SPIN_COUNT 1024
 
-    // We have the main logic in a loop in order to handle certain corner cases.
-    // E.g. carriage returns should be ignored, so we just continue to the next byte immediately.
-    for (;;) {
+struct TokenBatch {
+    size_t count;
+    int is_last;
+    struct Token *tokens; // batch_size + 1, the extra token holds the EOF position
+};
 
-        switch (getc(file)) {
-            case EOF: return 0;
-            case '\r': continue;
-
-            case 'a' ... 'z':
-            case 'A' ... 'Z':
-                token->type = TT_IDENTI;
-                for (;;) {
-                    int byte = getc(file);
-                    if (!is_identifier(byte)) {
-                        ungetc(byte, file);
-                        break;
-                    }
-                }
-                break;
+struct Pipeline {
+    struct Source src; // The lexer has its own position in the source.
+    size_t batch_size;
+    struct TokenBatch batches[PIPELINE_BATCH_COUNT];
+    size_t token_count; // Written by the lexer, read once it has finished
+    pthread_t thread;
+
+    // Written by the lexer
+    _Alignas(64) _Atomic size_t head;
+    size_t batch_count;
+    size_t lexer_stall_count;
+
+    // Written by the parser
+    _Alignas(64) _Atomic size_t tail;
+    _Atomic int is_stopped;
+
+    // Only used by the parser
+    _Alignas(64) struct TokenBatch *batch;
+    size_t index;
+    int is_finished;
+    struct Token end;
+    size_t parser_stall_count;
+};
 
-            case '0' ... '9':
-                token->type = TT_NUMBER;
-                for (;;) {
-                    int byte = getc(file);
-                    if (!is_number(byte)) {
-                        ungetc(byte, file);
-                        break;
-                    }
-                }
-                break;
+void pipeline_wait(size_t *spin_count) {
+    *spin_count += 1;
+    if (*spin_count > PIPELINE_SPIN_COUNT) {
+        sched_yield();
+    }
+}
 
-            case '\n':
-                token->type = TT_NEWLIN;
-                token->end = ftell(file);
-                line += 1;
-                col = 1;
-                return 1;
+void *pipeline_run(void *argument) {
+    struct Pipeline *pipeline = argument;
+    size_t head = 0;
 
-            case ' ':
-            case '\t':
-                token->type = TT_WSPACE;
-                for (;;) {
-                    int byte = getc(file);
-                    if (!is_whitespace(byte)) {
-                        ungetc(byte, file);
-                        break;
-                    }
-                }
-                break;
+    for (;;) {
+        // Wait for the parser to release a batch if the ring is full.
+        size_t spin_count = 0;
+        while (head - atomic_load_explicit(&pipeline->tail, memory_order_acquire) == PIPELINE_BATCH_COUNT) {
+            if (atomic_load_explicit(&pipeline->is_stopped, memory_order_relaxed)) {
+                return NULL;
+            }
+            pipeline_wait(&spin_count);
+        }
+        if (spin_count != 0) {
+            pipeline->lexer_stall_count += 1;
+        }
 
-            case '"':
-                token->type = TT_STRING;
-                for (;;) {
-                    int byte = getc(file);
-                    if (byte == '"') {
-                        token->end = ftell(file);
-                        col += token->end - token->start;
-                        return 1;
-                    }
-                }
-                break;
+        struct TokenBatch *batch = &pipeline->batches[head % PIPELINE_BATCH_COUNT];
+        batch->count = 0;
+        batch->is_last = 0;
 
-            case '(':
-                token->type = TT_LPAREN;
-                break;
-            case ')':
-                token->type = TT_RPAREN;
-                break;
-            case '{':
-                token->type = TT_LBRACE;
-                break;
-            case '}':
-                token->type = TT_RBRACE;
-                break;
-            case '[':
-                token->type = TT_LBRACK;
-                break;
-            case ']':
-                token->type = TT_RBRACK;
+        while (batch->count < pipeline->batch_size) {
+            struct Token *token = &batch->tokens[batch->count];
+            pipeline->token_count += 1;
+            if (!token_next(&pipeline->src, token)) {
+                batch->is_last = 1;
                 break;
+            }
+            if (token->type != TT_WSPACE && token->type != TT_NEWLIN) {
+                batch->count += 1;
+            }
+        }
 
-            default:
-                token->type = TT_UNDEFN;
-                break;
+        head += 1;
+        pipeline->batch_count += 1;
+        atomic_store_explicit(&pipeline->head, head, memory_order_release);
+
+        if (batch->is_last) {
+            return NULL;
         }
+    }
+}
 
-        // DEFAULT BEHAVIOR
-        // Set the end point (exclusive index).
-        // The length of the token value is end - start.
-        token->end = ftell(file);
-        col += token->end - token->start;
+// Returns 0 if the lexer thread could not be started, the tokens are then read directly.
+int pipeline_start(struct Pipeline *pipeline, struct Reader *reader, size_t batch_size) {
+    assert(pipeline != NULL);
+    assert(reader != NULL);
+    assert(batch_size > 0);
 
-        break;
+    memset(pipeline, 0, sizeof(*pipeline));
+    source_init(&pipeline->src, reader->src.data, reader->src.size);
+    pipeline->batch_size = batch_size;
+
+    for (size_t i = 0; i < PIPELINE_BATCH_COUNT; i += 1) {
+        pipeline->batches[i].tokens = malloc((batch_size + 1) * sizeof(struct Token));
+        assert(pipeline->batches[i].tokens != NULL);
+    }
+
+    if (pthread_create(&pipeline->thread, NULL, pipeline_run, pipeline) != 0) {
+        for (size_t i = 0; i < PIPELINE_BATCH_COUNT; i += 1) {
+            free(pipeline->batches[i].tokens);
+        }
+        return 0;
     }
 
+    reader->pipeline = pipeline;
     return 1;
 }
 
+void pipeline_stop(struct Pipeline *pipeline) {
+    assert(pipeline != NULL);
+
+    atomic_store_explicit(&pipeline->is_stopped, 1, memory_order_relaxed);
+    pthread_join(pipeline->thread, NULL);
+
+    for (size_t i = 0; i < PIPELINE_BATCH_COUNT; i += 1) {
+        free(pipeline->batches[i].tokens);
+    }
+}
+
+// Works like token_next, but takes the tokens from the lexer thread.
+int pipeline_next(struct Pipeline *pipeline, struct Token *token) {
+    for (;;) {
+        if (pipeline->batch == NULL) {
+            if (pipeline->is_finished) {
+                // The EOF token of the lexer thread, just like token_next returns it.
+                *token = pipeline->end;
+                return 0;
+            }
+
+            size_t tail = atomic_load_explicit(&pipeline->tail, memory_order_relaxed);
+
+            size_t spin_count = 0;
+            while (atomic_load_explicit(&pipeline->head, memory_order_acquire) == tail) {
+                pipeline_wait(&spin_count);
+            }
+            if (spin_count != 0) {
+                pipeline->parser_stall_count += 1;
+            }
+
+            pipeline->batch = &pipeline->batches[tail % PIPELINE_BATCH_COUNT];
+            pipeline->index = 0;
+        }
+
+        if (pipeline->index < pipeline->batch->count) {
+            *token = pipeline->batch->tokens[pipeline->index];
+            pipeline->index += 1;
+            return 1;
+        }
+
+        if (pipeline->batch->is_last) {
+            pipeline->end = pipeline->batch->tokens[pipeline->batch->count];
+            pipeline->is_finished = 1;
+        }
+
+        // The whole batch is consumed, hand it back to the lexer.
+        pipeline->batch = NULL;
+        atomic_fetch_add_explicit(&pipeline->tail, 1, memory_order_release);
+    }
+}
+
+#endif
+
+// Reads the next token for the parser, either directly or through the pipeline.
+int token_read(struct Reader *reader, struct Token *token) {
+#ifndef _WIN32
+    if (reader->pipeline != NULL) {
+        return pipeline_next(reader->pipeline, token);
+    }
+#endif
+    reader->token_count += 1;
+    return token_next(&reader->src, token);
+}
+
 int is_valid_value_token_type(enum TokenType token_type) {
     switch (token_type) {
         case TT_IDENTI:
         case TT_STRING:
         case TT_NUMBER:
+        case TT_LPAREN:
         case TT_LBRACE:
         case TT_LBRACK:
             return 1;
@@ -231,13 +360,13 @@ int is_valid_value_token_type(enum TokenType token_type) {
     return 0;
 }
 
-int is_valid_boolean_token_value(FILE *file, struct Token *token) {
-    assert(file != NULL);
+int is_valid_boolean_token_value(struct Reader *reader, struct Token *token) {
+    assert(reader != NULL);
     assert(token != NULL);
 
     return (
-        slice_equals(file, token->start, token->end, "true") ||
-        slice_equals(file, token->start, token->end, "false")
+        slice_equals(&reader->src, token->start, token->end, "true") ||
+        slice_equals(&reader->src, token->start, token->end, "false")
     );
 }
 
@@ -248,11 +377,11 @@ enum ReadRecordKeyErrorCode {
     READ_RECORD_KEY_ERROR_EOF,
 };
 
-enum ReadRecordKeyErrorCode read_record_key(FILE *file, struct Token *token) {
-    assert(file != NULL);
+enum ReadRecordKeyErrorCode read_record_key(struct Reader *reader, struct Token *token) {
+    assert(reader != NULL);
     assert(token != NULL);
 
-    while (token_next(file, token)) {
+    while (token_read(reader, token)) {
         switch (token->type) {
             case TT_NEWLIN:
             case TT_WSPACE:
@@ -276,11 +405,11 @@ enum ReadValueErrorCode {
     READ_VALUE_ERROR_EOF,
 };
 
-enum ReadValueErrorCode read_value(FILE *file, struct Token *token) {
-    assert(file != NULL);
+enum ReadValueErrorCode read_value(struct Reader *reader, struct Token *token) {
+    assert(reader != NULL);
     assert(token != NULL);
 
-    while (token_next(file, token)) {
+    while (token_read(reader, token)) {
         switch (token->type) {
             case TT_NEWLIN:
             case TT_WSPACE:
@@ -300,6 +429,10 @@ enum ProcessErrorCode {
     PROCESS_ERROR_NONE,
     PROCESS_ERROR_UNEXPECTED_TOKEN,
     PROCESS_ERROR_UNEXPECTED_EOF,
+    PROCESS_ERROR_INVALID_NUMBER,
+    PROCESS_ERROR_TYPE_MISMATCH,
+    PROCESS_ERROR_UNSUPPORTED_VALUE,
+    PROCESS_ERROR_INVALID_ESCAPE,
 };
 
 struct ProcessError {
@@ -307,36 +440,106 @@ struct ProcessError {
     struct Token token;
 };
 
-enum ProcessErrorCode process_record(FILE *src, FILE *dst, int is_root_record, struct ProcessError *error);
-enum ProcessErrorCode process_list(FILE *src, FILE *dst, struct ProcessError *error);
+struct Schema {
+    char **keys;
+    size_t count;
+    size_t capacity;
+};
 
-enum ProcessErrorCode process_value(FILE *src, FILE *dst, struct Token *token, struct ProcessError *error) {
-    assert(src != NULL);
+void schema_free(struct Schema *schema) {
+    assert(schema != NULL);
+
+    for (size_t i = 0; i < schema->count; i += 1) {
+        free(schema->keys[i]);
+    }
+    free(schema->keys);
+
+    schema->keys = NULL;
+    schema->count = 0;
+    schema->capacity = 0;
+}
+
+// Reads the key names of a schema, e.g. (name age).
+// The opening parenthesis must already be consumed.
+enum ProcessErrorCode read_schema(struct Reader *reader, struct Schema *schema, struct ProcessError *error) {
+    assert(reader != NULL);
+    assert(schema != NULL);
+    assert(error != NULL);
+
+    struct Token token = {0};
+
+    while (token_read(reader, &token)) {
+        switch (token.type) {
+            case TT_NEWLIN:
+            case TT_WSPACE:
+                continue;
+            case TT_RPAREN:
+                return PROCESS_ERROR_NONE;
+            case TT_IDENTI:
+                if (schema->count == schema->capacity) {
+                    schema->capacity = schema->capacity ? schema->capacity * 2 : 8;
+                    schema->keys = realloc(schema->keys, schema->capacity * sizeof(char*));
+                    assert(schema->keys != NULL);
+                }
+                schema->keys[schema->count] = slice_read(&reader->src, token.start, token.end);
+                schema->count += 1;
+                continue;
+            default:
+                error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                error->token = token;
+                return PROCESS_ERROR_UNEXPECTED_TOKEN;
+        }
+    }
+
+    error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+    error->token = token;
+    return PROCESS_ERROR_UNEXPECTED_EOF;
+}
+
+enum ProcessErrorCode process_record(struct Reader *reader, struct Buffer *dst, int is_root_record, struct ProcessError *error);
+enum ProcessErrorCode process_list(struct Reader *reader, struct Buffer *dst, struct ProcessError *error);
+enum ProcessErrorCode process_schema(struct Reader *reader, struct Buffer *dst, struct ProcessError *error);
+
+enum ProcessErrorCode process_value(struct Reader *reader, struct Buffer *dst, struct Token *token, struct ProcessError *error) {
+    assert(reader != NULL);
     assert(dst != NULL);
     assert(token != NULL);
     assert(error != NULL);
 
     switch (token->type) {
         case TT_IDENTI:
-            if (!is_valid_boolean_token_value(src, token)) {
+            if (!is_valid_boolean_token_value(reader, token)) {
                 error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
                 error->token = *token;
                 return PROCESS_ERROR_UNEXPECTED_TOKEN;
             }
-            slice_write(src, dst, token->start, token->end);
+            slice_write(&reader->src, dst, token->start, token->end);
             break;
         case TT_STRING:
+            if (!string_unescape(reader->src.data + token->start + 1, token->end - token->start - 2, NULL, NULL)) {
+                error->code = PROCESS_ERROR_INVALID_ESCAPE;
+                error->token = *token;
+                return PROCESS_ERROR_INVALID_ESCAPE;
+            }
+            slice_write_json_string(&reader->src, dst, token->start, token->end);
+            break;
         case TT_NUMBER:
-            slice_write(src, dst, token->start, token->end);
+            slice_write(&reader->src, dst, token->start, token->end);
             break;
         case TT_LBRACE: {
-            enum ProcessErrorCode error_code = process_record(src, dst, 0, error);
+            enum ProcessErrorCode error_code = process_record(reader, dst, 0, error);
             if (error_code != PROCESS_ERROR_NONE) {
                 return error_code;
             }
         } break;
         case TT_LBRACK: {
-            enum ProcessErrorCode error_code = process_list(src, dst, error);
+            enum ProcessErrorCode error_code = process_list(reader, dst, error);
+            if (error_code != PROCESS_ERROR_NONE) {
+                return error_code;
+            }
+        } break;
+        case TT_LPAREN: {
+            enum ProcessErrorCode error_code = process_schema(reader, dst, error);
             if (error_code != PROCESS_ERROR_NONE) {
                 return error_code;
             }
@@ -348,22 +551,22 @@ enum ProcessErrorCode process_value(FILE *src, FILE *dst, struct Token *token, s
     return PROCESS_ERROR_NONE;
 }
 
-enum ProcessErrorCode process_list(FILE *src, FILE *dst, struct ProcessError *error) {
-    assert(src != NULL);
+enum ProcessErrorCode process_list(struct Reader *reader, struct Buffer *dst, struct ProcessError *error) {
+    assert(reader != NULL);
     assert(dst != NULL);
     assert(error != NULL);
 
     int is_first_value = 1;
 
-    putc('[', dst);
+    buffer_putc(dst, '[');
 
     for (;;) {
         struct Token value;
 
-        switch (read_value(src, &value)) {
+        switch (read_value(reader, &value)) {
             case READ_VALUE_ERROR_NONE:
                 if (!is_first_value) {
-                    putc(',', dst);
+                    buffer_putc(dst, ',');
                 }
                 break;
             case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
@@ -377,7 +580,7 @@ enum ProcessErrorCode process_list(FILE *src, FILE *dst, struct ProcessError *er
                 goto EarlyReturn;
         }
 
-        if (process_value(src, dst, &value, error)) {
+        if (process_value(reader, dst, &value, error)) {
             return error->code;
         }
 
@@ -387,31 +590,31 @@ enum ProcessErrorCode process_list(FILE *src, FILE *dst, struct ProcessError *er
     }
 
 EarlyReturn:
-    putc(']', dst);
+    buffer_putc(dst, ']');
     return PROCESS_ERROR_NONE;
 }
 
-enum ProcessErrorCode process_record(FILE *src, FILE *dst, int is_root_record, struct ProcessError *error) {
-    assert(src != NULL);
+enum ProcessErrorCode process_record(struct Reader *reader, struct Buffer *dst, int is_root_record, struct ProcessError *error) {
+    assert(reader != NULL);
     assert(dst != NULL);
     assert(error != NULL);
 
     int is_first_key_value_pair = 1;
 
-    putc('{', dst);
+    buffer_putc(dst, '{');
 
     for (;;) {
         struct Token key;
         struct Token value;
 
-        switch (read_record_key(src, &key)) {
+        switch (read_record_key(reader, &key)) {
             case READ_RECORD_KEY_ERROR_NONE:
                 if (!is_first_key_value_pair) {
-                    putc(',', dst);
+                    buffer_putc(dst, ',');
                 }
-                putc('"', dst);
-                slice_write(src, dst, key.start, key.end);
-                putc('"', dst);
+                buffer_putc(dst, '"');
+                slice_write(&reader->src, dst, key.start, key.end);
+                buffer_putc(dst, '"');
                 break;
             case READ_RECORD_KEY_ERROR_END_OF_RECORD:
                 goto EarlyReturn;
@@ -428,9 +631,9 @@ enum ProcessErrorCode process_record(FILE *src, FILE *dst, int is_root_record, s
                 goto EarlyReturn;
         }
 
-        switch (read_value(src, &value)) {
+        switch (read_value(reader, &value)) {
             case READ_VALUE_ERROR_NONE:
-                putc(':', dst);
+                buffer_putc(dst, ':');
                 break;
             case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
                 error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
@@ -444,7 +647,7 @@ enum ProcessErrorCode process_record(FILE *src, FILE *dst, int is_root_record, s
 
         // If there's an error, just return it.
         // We won't be handling the error here.
-        if (process_value(src, dst, &value, error)) {
+        if (process_value(reader, dst, &value, error)) {
             return error->code;
         }
 
@@ -454,97 +657,1790 @@ enum ProcessErrorCode process_record(FILE *src, FILE *dst, int is_root_record, s
     }
 
 EarlyReturn:
-    putc('}', dst);
+    buffer_putc(dst, '}');
     return PROCESS_ERROR_NONE;
 }
 
-void write_file_content_to_file(FILE *src, FILE *dst) {
-    assert(src != NULL);
+// Writes the values of a schema record or a schema list as JSON objects.
+// A schema record holds exactly one row, a schema list holds any number of rows.
+enum ProcessErrorCode process_schema_rows(struct Reader *reader, struct Buffer *dst, struct Schema *schema, enum TokenType terminator, struct ProcessError *error) {
+    assert(reader != NULL);
     assert(dst != NULL);
+    assert(schema != NULL);
+    assert(error != NULL);
 
-    rewind(src);
+    size_t column = 0;
+    size_t row = 0;
 
     for (;;) {
-        int byte = getc(src);
-        if (byte == EOF) {
-            break;
+        struct Token value;
+
+        switch (read_value(reader, &value)) {
+            case READ_VALUE_ERROR_NONE:
+                // A schema record can only hold a single row of values.
+                if (schema->count == 0 || (terminator == TT_RBRACE && row == 1)) {
+                    error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                    error->token = value;
+                    return PROCESS_ERROR_UNEXPECTED_TOKEN;
+                }
+                break;
+            case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
+                // Rows must be complete before the schema value ends.
+                if (value.type != terminator || column != 0) {
+                    error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                    error->token = value;
+                    return PROCESS_ERROR_UNEXPECTED_TOKEN;
+                }
+                if (terminator == TT_RBRACE && row == 0) {
+                    buffer_puts(dst, "{}");
+                }
+                return PROCESS_ERROR_NONE;
+            case READ_VALUE_ERROR_EOF:
+                error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+                error->token = value;
+                return PROCESS_ERROR_UNEXPECTED_EOF;
+        }
+
+        if (column == 0) {
+            if (row != 0) {
+                buffer_putc(dst, ',');
+            }
+            buffer_putc(dst, '{');
+        } else {
+            buffer_putc(dst, ',');
+        }
+
+        buffer_putc(dst, '"');
+        buffer_puts(dst, schema->keys[column]);
+        buffer_putc(dst, '"');
+        buffer_putc(dst, ':');
+
+        if (process_value(reader, dst, &value, error)) {
+            return error->code;
+        }
+
+        column += 1;
+        if (column == schema->count) {
+            buffer_putc(dst, '}');
+            column = 0;
+            row += 1;
         }
-        putc(byte, dst);
     }
 }
 
-void write_string_to_file(char *src, FILE *dst) {
-    assert(src != NULL);
+// Processes a value that starts with a schema, e.g. (name age) [ ... ].
+// The opening parenthesis must already be consumed.
+enum ProcessErrorCode process_schema(struct Reader *reader, struct Buffer *dst, struct ProcessError *error) {
+    assert(reader != NULL);
     assert(dst != NULL);
+    assert(error != NULL);
 
-    for (;;) {
-        char byte = *src++;
-        if (byte == '\0') {
+    struct Schema schema = {0};
+    struct Token value;
+
+    if (read_schema(reader, &schema, error)) {
+        goto EarlyReturn;
+    }
+
+    switch (read_value(reader, &value)) {
+        case READ_VALUE_ERROR_NONE:
             break;
-        }
-        putc(byte, dst);
+        case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
+            error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+            error->token = value;
+            goto EarlyReturn;
+        case READ_VALUE_ERROR_EOF:
+            error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+            error->token = value;
+            goto EarlyReturn;
+    }
+
+    switch (value.type) {
+        case TT_LBRACK:
+            buffer_putc(dst, '[');
+            if (process_schema_rows(reader, dst, &schema, TT_RBRACK, error)) {
+                goto EarlyReturn;
+            }
+            buffer_putc(dst, ']');
+            break;
+        case TT_LBRACE:
+            if (process_schema_rows(reader, dst, &schema, TT_RBRACE, error)) {
+                goto EarlyReturn;
+            }
+            break;
+        default:
+            error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+            error->token = value;
+            goto EarlyReturn;
     }
+
+EarlyReturn:
+    schema_free(&schema);
+    return error->code;
 }
 
-struct ParseArgsResult {
-    char *src_path; // NULL => stdin
-    char *dst_path; // NULL => stdout
-    char *src_text; // NULL => nothing
+// COLUMNAR TABLES
+//
+// Schema lists at the root of a document can be loaded as tables of columns
+// instead of rows. Every column is a flat array of a single type, which makes
+// scanning one or two columns of a large table cheap.
+
+// Only one of the data arrays is in use, depending on the column type.
+// String columns keep count + 1 offsets into the blob, so that the length
+// of the value at index i is offsets[i + 1] - offsets[i].
+struct Column {
+    char *name;
+    enum ColumnType type;
+    size_t count;
+    size_t capacity;
+    int64_t *integers;
+    double *floats;
+    uint8_t *booleans;
+    uint64_t *offsets;
+    char *blob;
+    size_t blob_size;
+    size_t blob_capacity;
 };
 
-enum ParseArgsErrorCode {
-    PARSE_ARGS_ERROR_NONE,
-    PARSE_ARGS_ERROR_MISSING_ARG,
-    PARSE_ARGS_ERROR_INVALID_ARG,
+struct Table {
+    char *name;
+    size_t row_count;
+    size_t column_count;
+    struct Column *columns;
 };
 
-union ParseArgsErrorData {
-    char *missing_arg;
-    char *invalid_arg;
+struct TableList {
+    struct Table *tables;
+    size_t count;
+    size_t capacity;
 };
 
-struct ParseArgsError {
-    enum ParseArgsErrorCode code;
-    union ParseArgsErrorData data;
-};
+void column_reserve(struct Column *column, size_t count) {
+    assert(column != NULL);
 
-enum ParseArgsErrorCode parse_args(int argc, char **argv, struct ParseArgsResult *result, struct ParseArgsError *error) {
-    assert(argv != NULL);
-    assert(result != NULL);
-    assert(error != NULL);
+    if (count <= column->capacity) {
+        return;
+    }
 
-    error->code = PARSE_ARGS_ERROR_NONE;
+    size_t capacity = column->capacity ? column->capacity : 64;
+    while (capacity < count) {
+        capacity *= 2;
+    }
 
-    for (int i = 1; i < argc; i += 1) {
-        if (!strcmp(argv[i], "-i")) {
-            if (i + 1 >= argc) {
-                goto MissingArgumentError;
-            }
-            i += 1;
-            result->src_path = argv[i];
-        }
-        else if (!strcmp(argv[i], "-o")) {
-            if (i + 1 >= argc) {
-                goto MissingArgumentError;
-            }
-            i += 1;
-            result->dst_path = argv[i];
-        }
-        else if (!strcmp(argv[i], "-s")) {
-            if (i + 1 >= argc) {
-                goto MissingArgumentError;
-            }
-            i += 1;
-            result->src_text = argv[i];
-        }
-        else {
-            error->code = PARSE_ARGS_ERROR_INVALID_ARG;
-            error->data.invalid_arg = argv[i];
+    switch (column->type) {
+        case COLUMN_TYPE_INTEGER:
+            column->integers = realloc(column->integers, capacity * sizeof(int64_t));
+            assert(column->integers != NULL);
+            break;
+        case COLUMN_TYPE_FLOAT:
+            column->floats = realloc(column->floats, capacity * sizeof(double));
+            assert(column->floats != NULL);
+            break;
+        case COLUMN_TYPE_BOOLEAN:
+            column->booleans = realloc(column->booleans, capacity * sizeof(uint8_t));
+            assert(column->booleans != NULL);
+            break;
+        case COLUMN_TYPE_STRING:
+            column->offsets = realloc(column->offsets, (capacity + 1) * sizeof(uint64_t));
+            assert(column->offsets != NULL);
+            break;
+        case COLUMN_TYPE_UNDEFN:
+            break;
+    }
+
+    column->capacity = capacity;
+}
+
+// Integer columns are widened to floats once a float value shows up.
+void column_promote_to_float(struct Column *column) {
+    assert(column != NULL);
+    assert(column->type == COLUMN_TYPE_INTEGER);
+
+    column->floats = malloc((column->capacity ? column->capacity : 1) * sizeof(double));
+    assert(column->floats != NULL);
+
+    for (size_t i = 0; i < column->count; i += 1) {
+        column->floats[i] = (double)column->integers[i];
+    }
+
+    free(column->integers);
+    column->integers = NULL;
+    column->type = COLUMN_TYPE_FLOAT;
+}
+
+void column_free(struct Column *column) {
+    assert(column != NULL);
+    free(column->name);
+    free(column->integers);
+    free(column->floats);
+    free(column->booleans);
+    free(column->offsets);
+    free(column->blob);
+}
+
+void table_list_free(struct TableList *tables) {
+    assert(tables != NULL);
+
+    for (size_t i = 0; i < tables->count; i += 1) {
+        struct Table *table = &tables->tables[i];
+        for (size_t j = 0; j < table->column_count; j += 1) {
+            column_free(&table->columns[j]);
+        }
+        free(table->columns);
+        free(table->name);
+    }
+    free(tables->tables);
+
+    tables->tables = NULL;
+    tables->count = 0;
+    tables->capacity = 0;
+}
+
+// Parses a number token, ignoring the digit separators (underscores).
+// Returns the column type that the number fits into.
+enum ColumnType read_number(struct Reader *reader, struct Token *token, int64_t *integer, double *floating) {
+    assert(reader != NULL);
+    assert(token != NULL);
+    assert(integer != NULL);
+    assert(floating != NULL);
+
+    char buffer[64];
+    size_t size = 0;
+    int is_float = 0;
+
+    for (size_t i = token->start; i < token->end; i += 1) {
+        char byte = reader->src.data[i];
+        if (byte == '_') {
+            continue;
+        }
+        if (byte == '.' || byte == 'e' || byte == 'E') {
+            is_float = 1;
+        }
+        if (size + 1 == sizeof(buffer)) {
+            return COLUMN_TYPE_UNDEFN;
+        }
+        buffer[size++] = byte;
+    }
+    buffer[size] = '\0';
+
+    char *end;
+    errno = 0;
+
+    if (!is_float) {
+        *integer = strtoll(buffer, &end, 10);
+        if (errno == 0 && *end == '\0') {
+            return COLUMN_TYPE_INTEGER;
+        }
+        errno = 0;
+    }
+
+    *floating = strtod(buffer, &end);
+    if (errno != 0 || *end != '\0') {
+        return COLUMN_TYPE_UNDEFN;
+    }
+
+    return COLUMN_TYPE_FLOAT;
+}
+
+enum ProcessErrorCode column_append(struct Reader *reader, struct Column *column, struct Token *value, struct ProcessError *error) {
+    assert(reader != NULL);
+    assert(column != NULL);
+    assert(value != NULL);
+    assert(error != NULL);
+
+    enum ColumnType type;
+    int64_t integer = 0;
+    double floating = 0;
+    uint8_t boolean = 0;
+
+    switch (value->type) {
+        case TT_NUMBER:
+            type = read_number(reader, value, &integer, &floating);
+            if (type == COLUMN_TYPE_UNDEFN) {
+                error->code = PROCESS_ERROR_INVALID_NUMBER;
+                error->token = *value;
+                return PROCESS_ERROR_INVALID_NUMBER;
+            }
+            break;
+        case TT_STRING:
+            type = COLUMN_TYPE_STRING;
+            break;
+        case TT_IDENTI:
+            if (!is_valid_boolean_token_value(reader, value)) {
+                error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                error->token = *value;
+                return PROCESS_ERROR_UNEXPECTED_TOKEN;
+            }
+            type = COLUMN_TYPE_BOOLEAN;
+            boolean = slice_equals(&reader->src, value->start, value->end, "true");
+            break;
+        default:
+            // Records and lists have no flat representation.
+            error->code = PROCESS_ERROR_UNSUPPORTED_VALUE;
+            error->token = *value;
+            return PROCESS_ERROR_UNSUPPORTED_VALUE;
+    }
+
+    // The first value decides the column type.
+    // Integers and floats can be mixed, other types can not.
+    if (column->type == COLUMN_TYPE_UNDEFN) {
+        column->type = type;
+    }
+    else if (column->type == COLUMN_TYPE_INTEGER && type == COLUMN_TYPE_FLOAT) {
+        column_promote_to_float(column);
+    }
+    else if (column->type == COLUMN_TYPE_FLOAT && type == COLUMN_TYPE_INTEGER) {
+        type = COLUMN_TYPE_FLOAT;
+        floating = (double)integer;
+    }
+
+    if (column->type != type) {
+        error->code = PROCESS_ERROR_TYPE_MISMATCH;
+        error->token = *value;
+        return PROCESS_ERROR_TYPE_MISMATCH;
+    }
+
+    column_reserve(column, column->count + 1);
+
+    switch (type) {
+        case COLUMN_TYPE_INTEGER:
+            column->integers[column->count] = integer;
+            break;
+        case COLUMN_TYPE_FLOAT:
+            column->floats[column->count] = floating;
+            break;
+        case COLUMN_TYPE_BOOLEAN:
+            column->booleans[column->count] = boolean;
+            break;
+        case COLUMN_TYPE_STRING: {
+            // The blob holds the string values, without the quotes and with the escapes resolved.
+            // A value is never longer than its escaped form.
+            size_t size = value->end - value->start - 2;
+            if (column->blob_size + size > column->blob_capacity) {
+                size_t capacity = column->blob_capacity ? column->blob_capacity : 256;
+                while (capacity < column->blob_size + size) {
+                    capacity *= 2;
+                }
+                column->blob = realloc(column->blob, capacity);
+                assert(column->blob != NULL);
+                column->blob_capacity = capacity;
+            }
+            if (!string_unescape(reader->src.data + value->start + 1, size, column->blob + column->blob_size, &size)) {
+                error->code = PROCESS_ERROR_INVALID_ESCAPE;
+                error->token = *value;
+                return PROCESS_ERROR_INVALID_ESCAPE;
+            }
+            column->offsets[column->count] = column->blob_size;
+            column->blob_size += size;
+            column->offsets[column->count + 1] = column->blob_size;
+        } break;
+        case COLUMN_TYPE_UNDEFN:
+            break;
+    }
+
+    column->count += 1;
+
+    return PROCESS_ERROR_NONE;
+}
+
+// Loads the rows of a schema list into the columns of the table.
+// The opening bracket must already be consumed.
+enum ProcessErrorCode load_table_rows(struct Reader *reader, struct Table *table, struct ProcessError *error) {
+    assert(reader != NULL);
+    assert(table != NULL);
+    assert(error != NULL);
+
+    size_t column = 0;
+
+    for (;;) {
+        struct Token value;
+
+        switch (read_value(reader, &value)) {
+            case READ_VALUE_ERROR_NONE:
+                if (table->column_count == 0) {
+                    error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                    error->token = value;
+                    return PROCESS_ERROR_UNEXPECTED_TOKEN;
+                }
+                break;
+            case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
+                if (value.type != TT_RBRACK || column != 0) {
+                    error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                    error->token = value;
+                    return PROCESS_ERROR_UNEXPECTED_TOKEN;
+                }
+                return PROCESS_ERROR_NONE;
+            case READ_VALUE_ERROR_EOF:
+                error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+                error->token = value;
+                return PROCESS_ERROR_UNEXPECTED_EOF;
+        }
+
+        if (column_append(reader, &table->columns[column], &value, error)) {
+            return error->code;
+        }
+
+        column += 1;
+        if (column == table->column_count) {
+            column = 0;
+            table->row_count += 1;
+        }
+    }
+}
+
+// Loads a value that starts with a schema into a new table.
+// Schema records are validated into the sink, but they are not tables.
+// The opening parenthesis must already be consumed.
+enum ProcessErrorCode load_table(struct Reader *reader, struct Token *key, struct TableList *tables, struct Buffer *sink, struct ProcessError *error) {
+    assert(reader != NULL);
+    assert(key != NULL);
+    assert(sink != NULL);
+    assert(tables != NULL);
+    assert(error != NULL);
+
+    struct Schema schema = {0};
+    struct Token value;
+
+    if (read_schema(reader, &schema, error)) {
+        goto EarlyReturn;
+    }
+
+    switch (read_value(reader, &value)) {
+        case READ_VALUE_ERROR_NONE:
+            break;
+        case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
+            error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+            error->token = value;
+            goto EarlyReturn;
+        case READ_VALUE_ERROR_EOF:
+            error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+            error->token = value;
+            goto EarlyReturn;
+    }
+
+    if (value.type == TT_LBRACE) {
+        process_schema_rows(reader, sink, &schema, TT_RBRACE, error);
+        goto EarlyReturn;
+    }
+
+    if (value.type != TT_LBRACK) {
+        error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+        error->token = value;
+        goto EarlyReturn;
+    }
+
+    if (tables->count == tables->capacity) {
+        tables->capacity = tables->capacity ? tables->capacity * 2 : 8;
+        tables->tables = realloc(tables->tables, tables->capacity * sizeof(struct Table));
+        assert(tables->tables != NULL);
+    }
+
+    // The table takes over the key names of the schema.
+    struct Table *table = &tables->tables[tables->count];
+    tables->count += 1;
+
+    table->name = slice_read(&reader->src, key->start, key->end);
+    table->row_count = 0;
+    table->column_count = schema.count;
+    table->columns = calloc(schema.count ? schema.count : 1, sizeof(struct Column));
+    assert(table->columns != NULL);
+
+    for (size_t i = 0; i < schema.count; i += 1) {
+        table->columns[i].name = schema.keys[i];
+    }
+    schema.count = 0;
+
+    load_table_rows(reader, table, error);
+
+EarlyReturn:
+    schema_free(&schema);
+    return error->code;
+}
+
+// Loads every schema list at the root of the document as a table.
+// Other values are validated, but otherwise ignored.
+enum ProcessErrorCode load_tables(struct Reader *reader, struct TableList *tables, struct ProcessError *error) {
+    assert(reader != NULL);
+    assert(tables != NULL);
+    assert(error != NULL);
+
+    // Values that are not tables are still converted to check them,
+    // but the output is thrown away.
+    struct Buffer sink = {0};
+
+    for (;;) {
+        struct Token key;
+        struct Token value;
+
+        buffer_clear(&sink);
+
+        switch (read_record_key(reader, &key)) {
+            case READ_RECORD_KEY_ERROR_NONE:
+                break;
+            case READ_RECORD_KEY_ERROR_END_OF_RECORD:
+            case READ_RECORD_KEY_ERROR_EOF:
+                goto EarlyReturn;
+            case READ_RECORD_KEY_ERROR_UNEXPECTED_TOKEN:
+                error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                error->token = key;
+                goto EarlyReturn;
+        }
+
+        switch (read_value(reader, &value)) {
+            case READ_VALUE_ERROR_NONE:
+                break;
+            case READ_VALUE_ERROR_UNEXPECTED_TOKEN:
+                error->code = PROCESS_ERROR_UNEXPECTED_TOKEN;
+                error->token = value;
+                goto EarlyReturn;
+            case READ_VALUE_ERROR_EOF:
+                error->code = PROCESS_ERROR_UNEXPECTED_EOF;
+                error->token = value;
+                goto EarlyReturn;
+        }
+
+        if (value.type == TT_LPAREN) {
+            if (load_table(reader, &key, tables, &sink, error)) {
+                goto EarlyReturn;
+            }
+        }
+        else if (process_value(reader, &sink, &value, error)) {
+            goto EarlyReturn;
+        }
+    }
+
+EarlyReturn:
+    buffer_free(&sink);
+    return error->code;
+}
+
+// COLUMN FILES
+//
+// The file format and the reader are in myron_columns.h, so that other programs
+// can scan the columns without going through myron.c.
+
+// Returns the next 8 byte aligned offset for a section of the given size, and moves past the section.
+uint64_t column_file_reserve(uint64_t *offset, uint64_t size) {
+    assert(offset != NULL);
+
+    *offset = (*offset + 7) & ~(uint64_t)7;
+    uint64_t start = *offset;
+    *offset += size;
+
+    return start;
+}
+
+// Writes the bytes at the next 8 byte aligned offset. Returns 0 if the write failed.
+int column_file_put(FILE *dst, const void *data, size_t size, uint64_t *offset) {
+    assert(dst != NULL);
+    assert(offset != NULL);
+
+    static const char padding[8] = {0};
+    size_t padding_size = (8 - *offset % 8) % 8;
+
+    if (padding_size != 0 && fwrite(padding, 1, padding_size, dst) != padding_size) {
+        return 0;
+    }
+    if (size != 0 && fwrite(data, 1, size, dst) != size) {
+        return 0;
+    }
+    *offset += padding_size + size;
+
+    return 1;
+}
+
+const void *column_data(struct Column *column) {
+    switch (column->type) {
+        case COLUMN_TYPE_INTEGER:
+            return column->integers;
+        case COLUMN_TYPE_FLOAT:
+            return column->floats;
+        case COLUMN_TYPE_BOOLEAN:
+            return column->booleans;
+        case COLUMN_TYPE_STRING:
+            return column->offsets;
+        case COLUMN_TYPE_UNDEFN:
+            break;
+    }
+    return NULL;
+}
+
+// The layout is worked out first, so that the file can be written front to back
+// in a single pass, also into a pipe.
+enum ColumnFileErrorCode column_file_write(FILE *dst, struct TableList *tables) {
+    assert(dst != NULL);
+    assert(tables != NULL);
+
+    enum ColumnFileErrorCode result = COLUMN_FILE_ERROR_NONE;
+
+    size_t column_count = 0;
+    for (size_t i = 0; i < tables->count; i += 1) {
+        column_count += tables->tables[i].column_count;
+    }
+
+    struct ColumnFileTable *table_descriptors = calloc(tables->count + 1, sizeof(struct ColumnFileTable));
+    struct ColumnFileColumn *column_descriptors = calloc(column_count + 1, sizeof(struct ColumnFileColumn));
+    assert(table_descriptors != NULL);
+    assert(column_descriptors != NULL);
+
+    uint64_t offset = 0;
+    column_file_reserve(&offset, sizeof(struct ColumnFileHeader));
+
+    struct ColumnFileHeader header = {0};
+    memcpy(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic));
+    header.version = COLUMN_FILE_VERSION;
+    header.byte_order = COLUMN_FILE_BYTE_ORDER;
+    header.table_count = tables->count;
+    header.tables_offset = column_file_reserve(&offset, tables->count * sizeof(struct ColumnFileTable));
+
+    uint64_t columns_offset = column_file_reserve(&offset, column_count * sizeof(struct ColumnFileColumn));
+    struct ColumnFileColumn *column_descriptor = column_descriptors;
+
+    for (size_t i = 0; i < tables->count; i += 1) {
+        struct Table *table = &tables->tables[i];
+        struct ColumnFileTable *table_descriptor = &table_descriptors[i];
+
+        table_descriptor->name_size = strlen(table->name);
+        table_descriptor->name_offset = column_file_reserve(&offset, table_descriptor->name_size);
+        table_descriptor->row_count = table->row_count;
+        table_descriptor->column_count = table->column_count;
+        table_descriptor->columns_offset = columns_offset + (column_descriptor - column_descriptors) * sizeof(struct ColumnFileColumn);
+
+        for (size_t j = 0; j < table->column_count; j += 1, column_descriptor += 1) {
+            struct Column *column = &table->columns[j];
+            size_t row_count = table->row_count;
+
+            column_descriptor->name_size = strlen(column->name);
+            column_descriptor->name_offset = column_file_reserve(&offset, column_descriptor->name_size);
+            column_descriptor->type = column->type;
+
+            switch (column->type) {
+                case COLUMN_TYPE_INTEGER:
+                    column_descriptor->data_size = row_count * sizeof(int64_t);
+                    break;
+                case COLUMN_TYPE_FLOAT:
+                    column_descriptor->data_size = row_count * sizeof(double);
+                    break;
+                case COLUMN_TYPE_BOOLEAN:
+                    column_descriptor->data_size = row_count * sizeof(uint8_t);
+                    break;
+                case COLUMN_TYPE_STRING:
+                    column_descriptor->data_size = (row_count + 1) * sizeof(uint64_t);
+                    break;
+                case COLUMN_TYPE_UNDEFN:
+                    // Tables without rows have no column types.
+                    break;
+            }
+            column_descriptor->data_offset = column_file_reserve(&offset, column_descriptor->data_size);
+
+            if (column->type == COLUMN_TYPE_STRING) {
+                column_descriptor->blob_size = column->blob_size;
+                column_descriptor->blob_offset = column_file_reserve(&offset, column->blob_size);
+            }
+        }
+    }
+
+    // Write the sections in the same order as they were laid out.
+    offset = 0;
+    if (
+        !column_file_put(dst, &header, sizeof(header), &offset) ||
+        !column_file_put(dst, table_descriptors, tables->count * sizeof(struct ColumnFileTable), &offset) ||
+        !column_file_put(dst, column_descriptors, column_count * sizeof(struct ColumnFileColumn), &offset)
+    ) {
+        goto WriteError;
+    }
+
+    column_descriptor = column_descriptors;
+
+    for (size_t i = 0; i < tables->count; i += 1) {
+        struct Table *table = &tables->tables[i];
+
+        if (!column_file_put(dst, table->name, table_descriptors[i].name_size, &offset)) {
+            goto WriteError;
+        }
+
+        for (size_t j = 0; j < table->column_count; j += 1, column_descriptor += 1) {
+            struct Column *column = &table->columns[j];
+
+            if (
+                !column_file_put(dst, column->name, column_descriptor->name_size, &offset) ||
+                !column_file_put(dst, column_data(column), column_descriptor->data_size, &offset)
+            ) {
+                goto WriteError;
+            }
+            if (column->type == COLUMN_TYPE_STRING && !column_file_put(dst, column->blob, column->blob_size, &offset)) {
+                goto WriteError;
+            }
+        }
+    }
+
+    if (fflush(dst) != 0 || ferror(dst)) {
+        goto WriteError;
+    }
+
+    goto EarlyReturn;
+
+WriteError:
+    result = COLUMN_FILE_ERROR_WRITE;
+
+EarlyReturn:
+    free(table_descriptors);
+    free(column_descriptors);
+
+    return result;
+}
+
+// The blobs hold the string values, so quotes, backslashes and control characters are escaped again.
+void write_json_string(const char *data, size_t size, FILE *dst) {
+    putc('"', dst);
+
+    size_t start = 0;
+    for (size_t i = 0; i < size; i += 1) {
+        unsigned char byte = data[i];
+        if (byte >= 0x20 && byte != '"' && byte != '\\') {
+            continue;
+        }
+
+        fwrite(data + start, 1, i - start, dst);
+        start = i + 1;
+
+        switch (byte) {
+            case '"':
+                fputs("\\\"", dst);
+                break;
+            case '\\':
+                fputs("\\\\", dst);
+                break;
+            case '\n':
+                fputs("\\n", dst);
+                break;
+            case '\r':
+                fputs("\\r", dst);
+                break;
+            case '\t':
+                fputs("\\t", dst);
+                break;
+            default:
+                fprintf(dst, "\\u%04x", byte);
+                break;
+        }
+    }
+    fwrite(data + start, 1, size - start, dst);
+
+    putc('"', dst);
+}
+
+// Writes the tables of a column file as a JSON record of lists of records,
+// i.e. the same output that the original schema lists produce.
+void column_file_write_json(struct ColumnFile *file, FILE *dst) {
+    assert(file != NULL);
+    assert(dst != NULL);
+
+    putc('{', dst);
+
+    for (uint32_t i = 0; i < file->header->table_count; i += 1) {
+        const struct ColumnFileTable *table = &file->tables[i];
+        const struct ColumnFileColumn *columns = (const struct ColumnFileColumn*)(file->data + table->columns_offset);
+
+        if (i != 0) {
+            putc(',', dst);
+        }
+        write_json_string(file->data + table->name_offset, table->name_size, dst);
+        fputs(":[", dst);
+
+        for (uint64_t row = 0; row < table->row_count; row += 1) {
+            if (row != 0) {
+                putc(',', dst);
+            }
+            putc('{', dst);
+
+            for (uint64_t j = 0; j < table->column_count; j += 1) {
+                const struct ColumnFileColumn *column = &columns[j];
+                const char *data = file->data + column->data_offset;
+
+                if (j != 0) {
+                    putc(',', dst);
+                }
+                write_json_string(file->data + column->name_offset, column->name_size, dst);
+                putc(':', dst);
+
+                // The numbers are formatted like the writer does, so that the shortest
+                // form of a float comes out, e.g. 0.1 and 1.0, just like in the source.
+                char number[32];
+                switch (column->type) {
+                    case COLUMN_TYPE_INTEGER:
+                        fwrite(number, 1, myron_format_integer(number, ((const int64_t*)data)[row]), dst);
+                        break;
+                    case COLUMN_TYPE_FLOAT:
+                        fwrite(number, 1, myron_format_float(number, ((const double*)data)[row]), dst);
+                        break;
+                    case COLUMN_TYPE_BOOLEAN:
+                        fputs(((const uint8_t*)data)[row] ? "true" : "false", dst);
+                        break;
+                    case COLUMN_TYPE_STRING: {
+                        const uint64_t *offsets = (const uint64_t*)data;
+                        write_json_string(file->data + column->blob_offset + offsets[row], offsets[row + 1] - offsets[row], dst);
+                    } break;
+                }
+            }
+
+            putc('}', dst);
+        }
+
+        putc(']', dst);
+    }
+
+    putc('}', dst);
+}
+
+uint64_t monotonic_nanoseconds(void) {
+    struct timespec time;
+#ifdef _WIN32
+    timespec_get(&time, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &time);
+#endif
+    return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+void read_file_content(FILE *src, struct Buffer *dst) {
+    assert(src != NULL);
+    assert(dst != NULL);
+
+    for (;;) {
+        buffer_reserve(dst, 65536);
+        size_t size = fread(dst->data + dst->size, 1, dst->capacity - dst->size, src);
+        if (size == 0) {
+            break;
+        }
+        dst->size += size;
+    }
+}
+
+void format_process_error(struct ProcessError *error, char *message, size_t size) {
+    assert(error != NULL);
+    assert(message != NULL);
+
+    char *description = "";
+
+    switch (error->code) {
+        case PROCESS_ERROR_NONE:
+            break;
+        case PROCESS_ERROR_UNEXPECTED_TOKEN:
+            description = "Unexpected token";
+            break;
+        case PROCESS_ERROR_UNEXPECTED_EOF:
+            description = "Unexpected EOF after token";
+            break;
+        case PROCESS_ERROR_INVALID_NUMBER:
+            description = "Invalid number";
+            break;
+        case PROCESS_ERROR_TYPE_MISMATCH:
+            description = "Column type mismatch";
+            break;
+        case PROCESS_ERROR_UNSUPPORTED_VALUE:
+            description = "Value can not be stored in a column";
+            break;
+        case PROCESS_ERROR_INVALID_ESCAPE:
+            description = "Invalid string escape";
+            break;
+    }
+
+    snprintf(
+        message, size, "%s: %s (ln: %llu, col: %llu}", description,
+        token_type_to_string(error->token.type), (unsigned long long)error->token.line, (unsigned long long)error->token.col
+    );
+}
+
+void print_process_error(struct ProcessError *error) {
+    char message[256];
+    format_process_error(error, message, sizeof(message));
+    fprintf(stderr, "[ERROR] %s\n", message);
+}
+
+// WRITER BENCHMARK
+//
+// Generates a table of people with the writer, once through an explicit table
+// and once as a list of records that is rewritten as a schema list, and then
+// converts the output to JSON. Both forms must produce the same output.
+
+void bench_writer_rows(struct MyronWriter *writer, size_t row_count, int is_table) {
+    assert(writer != NULL);
+
+    static const char *const names[] = {"Alice", "Bob", "Carol", "Dave \"The Brave\""};
+    static const char *const columns[] = {"id", "name", "age", "score", "active"};
+
+    myron_write_key(writer, "people");
+    if (is_table) {
+        myron_begin_table(writer, columns, 5);
+    } else {
+        myron_begin_list(writer);
+    }
+
+    for (size_t i = 0; i < row_count; i += 1) {
+        if (!is_table) {
+            myron_begin_record(writer);
+            myron_write_key(writer, "id");
+        }
+        myron_write_integer(writer, (int64_t)i);
+        if (!is_table) {
+            myron_write_key(writer, "name");
+        }
+        myron_write_string(writer, names[i % 4]);
+        if (!is_table) {
+            myron_write_key(writer, "age");
+        }
+        myron_write_integer(writer, 18 + (int64_t)(i % 80));
+        if (!is_table) {
+            myron_write_key(writer, "score");
+        }
+        myron_write_float(writer, (double)((int64_t)(i % 10000) - 5000) / 100);
+        if (!is_table) {
+            myron_write_key(writer, "active");
+        }
+        myron_write_boolean(writer, i % 3 == 0);
+        if (!is_table) {
+            myron_end_record(writer);
+        }
+    }
+
+    if (is_table) {
+        myron_end_table(writer);
+    } else {
+        myron_end_list(writer);
+    }
+}
+
+int bench_writer(size_t row_count, FILE *dst) {
+    assert(dst != NULL);
+
+    struct MyronWriter table;
+    struct MyronWriter records;
+    myron_writer_init(&table, NULL);
+    myron_writer_init(&records, NULL);
+
+    uint64_t start = monotonic_nanoseconds();
+    bench_writer_rows(&table, row_count, 1);
+    uint64_t table_time = monotonic_nanoseconds() - start;
+
+    start = monotonic_nanoseconds();
+    bench_writer_rows(&records, row_count, 0);
+    uint64_t records_time = monotonic_nanoseconds() - start;
+
+    if (table.size != records.size || memcmp(table.data, records.data, table.size)) {
+        fprintf(stderr, "[ERROR] The table and the records produced different output\n");
+        return 1;
+    }
+
+    struct Reader reader;
+    struct Buffer output = {0};
+    struct ProcessError error = {0};
+    reader_init(&reader, table.data, table.size);
+
+    start = monotonic_nanoseconds();
+    if (process_record(&reader, &output, 1, &error)) {
+        print_process_error(&error);
+        return 1;
+    }
+    uint64_t json_time = monotonic_nanoseconds() - start;
+
+    fprintf(dst, "rows:         %zu\n", row_count);
+    fprintf(dst, "myron:        %zu bytes\n", table.size);
+    fprintf(dst, "json:         %zu bytes\n", output.size);
+    fprintf(dst, "write table:  %.3f ms (%.1f MB/s)\n", table_time / 1e6, table.size / (table_time / 1e9) / 1e6);
+    fprintf(dst, "write list:   %.3f ms (%.1f MB/s)\n", records_time / 1e6, records.size / (records_time / 1e9) / 1e6);
+    fprintf(dst, "to json:      %.3f ms (%.1f MB/s)\n", json_time / 1e6, table.size / (json_time / 1e9) / 1e6);
+
+    buffer_free(&output);
+    myron_writer_free(&table);
+    myron_writer_free(&records);
+    return 0;
+}
+
+#ifndef _WIN32
+
+// SERVER
+//
+// The server converts myron to JSON over a Unix domain socket, so that the
+// process startup is only paid once. A connection can carry any number of requests.
+//
+//     request:  payload size (4 bytes, big endian), myron payload
+//     response: status (1 byte), body size (4 bytes, big endian), body
+//
+// The body is JSON when the status is SERVER_STATUS_OK and an error diagnostic otherwise.
+//
+// The main thread polls the connections and reads the requests without blocking.
+// A connection is handed to a worker only once its whole request has arrived, and
+// the worker returns it to the poller after the response, so neither idle nor slow
+// clients hold on to workers.
+
+#define SERVER_MAX_PAYLOAD_SIZE (64 * 1024 * 1024)
+#define SERVER_QUEUE_SIZE 256
+#define SERVER_HEADER_SIZE 5
+#define SERVER_RECEIVE_SIZE (64 * 1024)
+#define SERVER_TIMEOUT_SECONDS 5
+
+enum ServerStatus {
+    SERVER_STATUS_OK,
+    SERVER_STATUS_ERROR,
+};
+
+int read_exact(int fd, void *data, size_t size) {
+    char *bytes = data;
+    while (size != 0) {
+        ssize_t count = read(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return 0;
+        }
+        bytes += count;
+        size -= count;
+    }
+    return 1;
+}
+
+int write_exact(int fd, const void *data, size_t size) {
+    const char *bytes = data;
+    while (size != 0) {
+        ssize_t count = write(fd, bytes, size);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return 0;
+        }
+        bytes += count;
+        size -= count;
+    }
+    return 1;
+}
+
+void write_u32(unsigned char *bytes, uint32_t value) {
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+uint32_t read_u32(const unsigned char *bytes) {
+    return (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 | (uint32_t)bytes[2] << 8 | (uint32_t)bytes[3];
+}
+
+// A connection collects its request piece by piece, as the bytes arrive.
+// The request buffer is reused for the following requests of the connection.
+struct Connection {
+    int fd;
+    unsigned char header[4];
+    size_t header_size;
+    uint32_t payload_size;
+    struct Buffer request;
+};
+
+enum ReceiveStatus {
+    RECEIVE_PENDING,
+    RECEIVE_COMPLETE,
+    RECEIVE_CLOSED,
+};
+
+struct Connection *connection_new(int fd) {
+    struct Connection *connection = calloc(1, sizeof(struct Connection));
+    assert(connection != NULL);
+    connection->fd = fd;
+    return connection;
+}
+
+void connection_free(struct Connection *connection) {
+    close(connection->fd);
+    buffer_free(&connection->request);
+    free(connection);
+}
+
+// Reads whatever has arrived of the request without blocking. Nothing past the
+// request is read, so the next request of a pipelining client stays in the socket.
+// A payload that is too large completes the request right after the header.
+enum ReceiveStatus connection_receive(struct Connection *connection) {
+    for (;;) {
+        void *data;
+        size_t size;
+
+        if (connection->header_size < sizeof(connection->header)) {
+            data = connection->header + connection->header_size;
+            size = sizeof(connection->header) - connection->header_size;
+        } else if (connection->payload_size > SERVER_MAX_PAYLOAD_SIZE) {
+            return RECEIVE_COMPLETE;
+        } else if (connection->request.size < connection->payload_size) {
+            // The buffer grows with the bytes that arrive, not with the size that the header claims.
+            size = connection->payload_size - connection->request.size;
+            size = size < SERVER_RECEIVE_SIZE ? size : SERVER_RECEIVE_SIZE;
+            buffer_reserve(&connection->request, size);
+            data = connection->request.data + connection->request.size;
+        } else {
+            return RECEIVE_COMPLETE;
+        }
+
+        ssize_t count = recv(connection->fd, data, size, MSG_DONTWAIT);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return RECEIVE_PENDING;
+        }
+        if (count <= 0) {
+            return RECEIVE_CLOSED;
+        }
+
+        if (connection->header_size < sizeof(connection->header)) {
+            connection->header_size += count;
+            if (connection->header_size == sizeof(connection->header)) {
+                connection->payload_size = read_u32(connection->header);
+                buffer_clear(&connection->request);
+            }
+        } else {
+            connection->request.size += count;
+        }
+    }
+}
+
+// Connections with a complete request wait in a bounded queue until a worker is free.
+// Workers hand the connections back through the returned list, and wake the poller up through a pipe.
+struct Server {
+    int socket;
+    int wake[2];
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    struct Connection *queue[SERVER_QUEUE_SIZE];
+    size_t head;
+    size_t count;
+    struct Connection **returned;
+    size_t returned_count;
+    size_t returned_capacity;
+};
+
+// The response buffer of a worker is reused across requests,
+// so that a warmed up worker does not allocate memory.
+struct Worker {
+    pthread_t thread;
+    struct Server *server;
+    struct Buffer response;
+};
+
+void server_push(struct Server *server, struct Connection *connection) {
+    pthread_mutex_lock(&server->mutex);
+    while (server->count == SERVER_QUEUE_SIZE) {
+        pthread_cond_wait(&server->not_full, &server->mutex);
+    }
+    server->queue[(server->head + server->count) % SERVER_QUEUE_SIZE] = connection;
+    server->count += 1;
+    pthread_cond_signal(&server->not_empty);
+    pthread_mutex_unlock(&server->mutex);
+}
+
+struct Connection *server_pop(struct Server *server) {
+    pthread_mutex_lock(&server->mutex);
+    while (server->count == 0) {
+        pthread_cond_wait(&server->not_empty, &server->mutex);
+    }
+    struct Connection *connection = server->queue[server->head];
+    server->head = (server->head + 1) % SERVER_QUEUE_SIZE;
+    server->count -= 1;
+    pthread_cond_signal(&server->not_full);
+    pthread_mutex_unlock(&server->mutex);
+    return connection;
+}
+
+// Hands the connection back to the poller to wait for its next request.
+void server_return(struct Server *server, struct Connection *connection) {
+    pthread_mutex_lock(&server->mutex);
+    if (server->returned_count == server->returned_capacity) {
+        server->returned_capacity = server->returned_capacity ? server->returned_capacity * 2 : 64;
+        server->returned = realloc(server->returned, server->returned_capacity * sizeof(struct Connection*));
+        assert(server->returned != NULL);
+    }
+    server->returned[server->returned_count] = connection;
+    server->returned_count += 1;
+    pthread_mutex_unlock(&server->mutex);
+
+    // The pipe is non-blocking, a full pipe already wakes the poller up.
+    char byte = 0;
+    if (write(server->wake[1], &byte, 1) < 0) {}
+}
+
+void server_response_begin(struct Buffer *response) {
+    buffer_clear(response);
+    buffer_reserve(response, SERVER_HEADER_SIZE);
+    response->size = SERVER_HEADER_SIZE;
+}
+
+void server_response_end(struct Buffer *response, enum ServerStatus status) {
+    response->data[0] = status;
+    write_u32((unsigned char*)response->data + 1, response->size - SERVER_HEADER_SIZE);
+}
+
+// Converts the request payload and writes the whole response,
+// header included, into the response buffer.
+void server_convert(struct Buffer *request, struct Buffer *response) {
+    assert(request != NULL);
+    assert(response != NULL);
+
+    struct Reader reader;
+    reader_init(&reader, request->data, request->size);
+
+    server_response_begin(response);
+
+    struct ProcessError error = {0};
+    if (process_record(&reader, response, 1, &error)) {
+        char message[256];
+        format_process_error(&error, message, sizeof(message));
+        server_response_begin(response);
+        buffer_puts(response, message);
+        server_response_end(response, SERVER_STATUS_ERROR);
+        return;
+    }
+
+    server_response_end(response, SERVER_STATUS_OK);
+}
+
+// Answers the complete request of the connection. Returns 0 once the connection should be closed.
+// A client that does not read its response times out, see SERVER_TIMEOUT_SECONDS.
+int worker_serve(struct Worker *worker, struct Connection *connection) {
+    connection->header_size = 0;
+
+    if (connection->payload_size > SERVER_MAX_PAYLOAD_SIZE) {
+        server_response_begin(&worker->response);
+        buffer_puts(&worker->response, "Payload too large");
+        server_response_end(&worker->response, SERVER_STATUS_ERROR);
+        write_exact(connection->fd, worker->response.data, worker->response.size);
+        return 0;
+    }
+
+    server_convert(&connection->request, &worker->response);
+
+    return write_exact(connection->fd, worker->response.data, worker->response.size);
+}
+
+void *worker_run(void *argument) {
+    struct Worker *worker = argument;
+
+    for (;;) {
+        struct Connection *connection = server_pop(worker->server);
+        if (worker_serve(worker, connection)) {
+            server_return(worker->server, connection);
+        } else {
+            connection_free(connection);
+        }
+    }
+
+    return NULL;
+}
+
+// The connections that the main thread waits on, next to their poll entries.
+// The first two entries are the listening socket and the wake up pipe, without a connection.
+struct PollSet {
+    struct pollfd *fds;
+    struct Connection **connections;
+    size_t count;
+    size_t capacity;
+};
+
+void poll_set_add(struct PollSet *set, int fd, struct Connection *connection) {
+    if (set->count == set->capacity) {
+        set->capacity = set->capacity ? set->capacity * 2 : 64;
+        set->fds = realloc(set->fds, set->capacity * sizeof(struct pollfd));
+        set->connections = realloc(set->connections, set->capacity * sizeof(struct Connection*));
+        assert(set->fds != NULL);
+        assert(set->connections != NULL);
+    }
+    set->fds[set->count].fd = fd;
+    set->fds[set->count].events = POLLIN;
+    set->fds[set->count].revents = 0;
+    set->connections[set->count] = connection;
+    set->count += 1;
+}
+
+void poll_set_remove(struct PollSet *set, size_t index) {
+    set->count -= 1;
+    set->fds[index] = set->fds[set->count];
+    set->connections[index] = set->connections[set->count];
+}
+
+static const char *serve_socket_path = NULL;
+
+void serve_stop(int signal_number) {
+    (void)signal_number;
+    unlink(serve_socket_path);
+    _exit(0);
+}
+
+enum ServeErrorCode {
+    SERVE_ERROR_NONE,
+    SERVE_ERROR_SOCKET_PATH,
+    SERVE_ERROR_SOCKET,
+    SERVE_ERROR_THREAD,
+};
+
+union ServeErrorData {
+    int system_error;
+};
+
+struct ServeError {
+    enum ServeErrorCode code;
+    union ServeErrorData data;
+};
+
+// Runs the server until it is terminated with a signal.
+enum ServeErrorCode serve(const char *path, size_t thread_count, struct ServeError *error) {
+    assert(path != NULL);
+    assert(thread_count > 0);
+    assert(error != NULL);
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        error->code = SERVE_ERROR_SOCKET_PATH;
+        return SERVE_ERROR_SOCKET_PATH;
+    }
+    strcpy(address.sun_path, path);
+
+    // Only a stale socket may be replaced, anything else at the path is left alone.
+    struct stat status;
+    if (lstat(path, &status) == 0) {
+        if (!S_ISSOCK(status.st_mode)) {
+            error->code = SERVE_ERROR_SOCKET_PATH;
+            return SERVE_ERROR_SOCKET_PATH;
+        }
+        unlink(path);
+    }
+
+    struct Server server = {0};
+    server.socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (
+        server.socket < 0 ||
+        pipe(server.wake) < 0 ||
+        fcntl(server.wake[0], F_SETFL, O_NONBLOCK) < 0 ||
+        fcntl(server.wake[1], F_SETFL, O_NONBLOCK) < 0 ||
+        bind(server.socket, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(server.socket, SOMAXCONN) < 0
+    ) {
+        error->code = SERVE_ERROR_SOCKET;
+        error->data.system_error = errno;
+        return SERVE_ERROR_SOCKET;
+    }
+
+    // Clients that disconnect early must not take the server down.
+    serve_socket_path = path;
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, serve_stop);
+    signal(SIGTERM, serve_stop);
+
+    pthread_mutex_init(&server.mutex, NULL);
+    pthread_cond_init(&server.not_empty, NULL);
+    pthread_cond_init(&server.not_full, NULL);
+
+    struct Worker *workers = calloc(thread_count, sizeof(struct Worker));
+    assert(workers != NULL);
+
+    // The server runs with the workers that could be started, but not without any.
+    size_t worker_count = 0;
+    for (size_t i = 0; i < thread_count; i += 1) {
+        workers[i].server = &server;
+        int result = pthread_create(&workers[i].thread, NULL, worker_run, &workers[i]);
+        if (result != 0) {
+            error->data.system_error = result;
             break;
         }
+        worker_count += 1;
+    }
+    if (worker_count == 0) {
+        close(server.socket);
+        close(server.wake[0]);
+        close(server.wake[1]);
+        unlink(path);
+        free(workers);
+        error->code = SERVE_ERROR_THREAD;
+        return SERVE_ERROR_THREAD;
+    }
+    if (worker_count < thread_count) {
+        fprintf(stderr, "[WARNING] Started only %zu of %zu worker threads: %s\n", worker_count, thread_count, strerror(error->data.system_error));
+    }
+
+    struct PollSet set = {0};
+    poll_set_add(&set, server.socket, NULL);
+    poll_set_add(&set, server.wake[0], NULL);
+
+    struct timeval timeout = {SERVER_TIMEOUT_SECONDS, 0};
+
+    for (;;) {
+        if (poll(set.fds, set.count, -1) < 0) {
+            continue;
+        }
+
+        // Connections with a complete request go to the workers.
+        for (size_t i = set.count; i-- > 2;) {
+            if (set.fds[i].revents == 0) {
+                continue;
+            }
+            struct Connection *connection = set.connections[i];
+            switch (connection_receive(connection)) {
+                case RECEIVE_PENDING:
+                    break;
+                case RECEIVE_COMPLETE:
+                    poll_set_remove(&set, i);
+                    server_push(&server, connection);
+                    break;
+                case RECEIVE_CLOSED:
+                    poll_set_remove(&set, i);
+                    connection_free(connection);
+                    break;
+            }
+        }
+
+        if (set.fds[1].revents != 0) {
+            char bytes[256];
+            while (read(server.wake[0], bytes, sizeof(bytes)) > 0) {}
+
+            pthread_mutex_lock(&server.mutex);
+            for (size_t i = 0; i < server.returned_count; i += 1) {
+                poll_set_add(&set, server.returned[i]->fd, server.returned[i]);
+            }
+            server.returned_count = 0;
+            pthread_mutex_unlock(&server.mutex);
+        }
+
+        if (set.fds[0].revents != 0) {
+            int fd = accept(server.socket, NULL, NULL);
+            if (fd >= 0) {
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                poll_set_add(&set, fd, connection_new(fd));
+            }
+        }
+    }
+
+    return SERVE_ERROR_NONE;
+}
+
+// CLIENT
+
+int client_connect(const char *path) {
+    assert(path != NULL);
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection < 0) {
+        return -1;
+    }
+
+    if (connect(connection, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        close(connection);
+        return -1;
+    }
+
+    return connection;
+}
+
+// Sends a single request and reads the response body into the buffer.
+// Returns the response status, or -1 if the connection failed.
+int client_request(int connection, const char *payload, size_t size, struct Buffer *response) {
+    assert(payload != NULL || size == 0);
+    assert(response != NULL);
+
+    unsigned char header[SERVER_HEADER_SIZE];
+    write_u32(header, size);
+
+    if (!write_exact(connection, header, 4) || !write_exact(connection, payload, size)) {
+        return -1;
+    }
+
+    if (!read_exact(connection, header, SERVER_HEADER_SIZE)) {
+        return -1;
+    }
+
+    uint32_t body_size = read_u32(header + 1);
+    buffer_clear(response);
+    buffer_reserve(response, body_size);
+    if (!read_exact(connection, response->data, body_size)) {
+        return -1;
+    }
+    response->size = body_size;
+
+    return header[0];
+}
+
+// The load generator runs one connection per thread.
+struct BenchConnection {
+    pthread_t thread;
+    const char *path;
+    const char *payload;
+    size_t payload_size;
+    size_t request_count;
+    uint64_t *latencies;
+    size_t failure_count;
+};
+
+void *bench_connection_run(void *argument) {
+    struct BenchConnection *bench = argument;
+    struct Buffer response = {0};
+
+    int connection = client_connect(bench->path);
+
+    for (size_t i = 0; i < bench->request_count; i += 1) {
+        uint64_t start = monotonic_nanoseconds();
+        int status = connection < 0 ? -1 : client_request(connection, bench->payload, bench->payload_size, &response);
+        bench->latencies[i] = monotonic_nanoseconds() - start;
+
+        if (status != SERVER_STATUS_OK) {
+            bench->failure_count += 1;
+        }
+    }
+
+    if (connection >= 0) {
+        close(connection);
+    }
+    buffer_free(&response);
+
+    return NULL;
+}
+
+int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+void bench(const char *path, struct Buffer *payload, size_t request_count, size_t connection_count, FILE *dst) {
+    assert(path != NULL);
+    assert(payload != NULL);
+    assert(connection_count > 0);
+    assert(dst != NULL);
+
+    uint64_t *latencies = calloc(request_count + 1, sizeof(uint64_t));
+    struct BenchConnection *connections = calloc(connection_count, sizeof(struct BenchConnection));
+    assert(latencies != NULL);
+    assert(connections != NULL);
+
+    uint64_t start = monotonic_nanoseconds();
+    size_t offset = 0;
+
+    for (size_t i = 0; i < connection_count; i += 1) {
+        struct BenchConnection *connection = &connections[i];
+        connection->path = path;
+        connection->payload = payload->data;
+        connection->payload_size = payload->size;
+        connection->request_count = request_count / connection_count + (i < request_count % connection_count);
+        connection->latencies = latencies + offset;
+        offset += connection->request_count;
+        pthread_create(&connection->thread, NULL, bench_connection_run, connection);
+    }
+
+    size_t failure_count = 0;
+    for (size_t i = 0; i < connection_count; i += 1) {
+        pthread_join(connections[i].thread, NULL);
+        failure_count += connections[i].failure_count;
+    }
+
+    double seconds = (monotonic_nanoseconds() - start) / 1e9;
+
+    qsort(latencies, request_count, sizeof(uint64_t), compare_u64);
+    uint64_t p50 = request_count ? latencies[request_count * 50 / 100] : 0;
+    uint64_t p99 = request_count ? latencies[request_count * 99 / 100] : 0;
+
+    fprintf(dst, "requests:    %zu (%zu failed)\n", request_count, failure_count);
+    fprintf(dst, "connections: %zu\n", connection_count);
+    fprintf(dst, "payload:     %zu bytes\n", payload->size);
+    fprintf(dst, "time:        %.3f s\n", seconds);
+    fprintf(dst, "throughput:  %.0f requests/s, %.1f MB/s\n", request_count / seconds, request_count * payload->size / seconds / 1e6);
+    fprintf(dst, "latency p50: %.1f us\n", p50 / 1e3);
+    fprintf(dst, "latency p99: %.1f us\n", p99 / 1e3);
+
+    free(latencies);
+    free(connections);
+}
+
+#endif
+
+struct ParseArgsResult {
+    char *src_path; // NULL => stdin
+    char *dst_path; // NULL => stdout
+    char *src_text; // NULL => nothing
+    char *columns_path; // NULL => JSON output
+    char *serve_path; // NULL => no server
+    char *connect_path; // NULL => no client
+    char *bench_path; // NULL => no load generator
+    size_t thread_count; // 0 => one per CPU
+    size_t request_count; // 0 => default
+    size_t connection_count; // 0 => default
+    int is_pipelined;
+    size_t batch_size; // 0 => default
+    int is_stats_enabled;
+    size_t writer_row_count; // 0 => no writer benchmark
+};
+
+enum ParseArgsErrorCode {
+    PARSE_ARGS_ERROR_NONE,
+    PARSE_ARGS_ERROR_MISSING_ARG,
+    PARSE_ARGS_ERROR_INVALID_ARG,
+};
+
+union ParseArgsErrorData {
+    char *missing_arg;
+    char *invalid_arg;
+};
+
+struct ParseArgsError {
+    enum ParseArgsErrorCode code;
+    union ParseArgsErrorData data;
+};
+
+// Parses a positive count, returns 0 if the argument is not one.
+size_t parse_count(char *arg) {
+    assert(arg != NULL);
+
+    char *end;
+    errno = 0;
+    unsigned long long count = strtoull(arg, &end, 10);
+
+    if (errno != 0 || *end != '\0' || end == arg || arg[0] == '-') {
+        return 0;
+    }
+
+    return count;
+}
+
+enum ParseArgsErrorCode parse_args(int argc, char **argv, struct ParseArgsResult *result, struct ParseArgsError *error) {
+    assert(argv != NULL);
+    assert(result != NULL);
+    assert(error != NULL);
+
+    error->code = PARSE_ARGS_ERROR_NONE;
+
+    for (int i = 1; i < argc; i += 1) {
+        if (!strcmp(argv[i], "-i")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->src_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "-o")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->dst_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "-s")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->src_text = argv[i];
+        }
+        else if (!strcmp(argv[i], "-c")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->columns_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "--serve")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->serve_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "--connect")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->connect_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "--bench")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->bench_path = argv[i];
+        }
+        else if (!strcmp(argv[i], "--threads")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->thread_count = parse_count(argv[i]);
+            if (result->thread_count == 0) {
+                goto InvalidArgumentError;
+            }
+        }
+        else if (!strcmp(argv[i], "--requests")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->request_count = parse_count(argv[i]);
+            if (result->request_count == 0) {
+                goto InvalidArgumentError;
+            }
+        }
+        else if (!strcmp(argv[i], "--connections")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->connection_count = parse_count(argv[i]);
+            if (result->connection_count == 0) {
+                goto InvalidArgumentError;
+            }
+        }
+        else if (!strcmp(argv[i], "--pipeline")) {
+            result->is_pipelined = 1;
+        }
+        else if (!strcmp(argv[i], "--batch")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->batch_size = parse_count(argv[i]);
+            if (result->batch_size == 0) {
+                goto InvalidArgumentError;
+            }
+        }
+        else if (!strcmp(argv[i], "--stats")) {
+            result->is_stats_enabled = 1;
+        }
+        else if (!strcmp(argv[i], "--bench-writer")) {
+            if (i + 1 >= argc) {
+                goto MissingArgumentError;
+            }
+            i += 1;
+            result->writer_row_count = parse_count(argv[i]);
+            if (result->writer_row_count == 0) {
+                goto InvalidArgumentError;
+            }
+        }
+        else {
+            goto InvalidArgumentError;
+        }
 
         continue;
 
+InvalidArgumentError:
+        error->code = PARSE_ARGS_ERROR_INVALID_ARG;
+        error->data.invalid_arg = argv[i];
+        break;
+
 MissingArgumentError:
         error->code = PARSE_ARGS_ERROR_MISSING_ARG;
         error->data.missing_arg = argv[i];
@@ -564,8 +2460,9 @@ long file_size(FILE *file) {
 }
 
 struct ProcessArgsResult {
-    FILE *src;
+    struct Buffer src; // Empty for column files, they are mapped instead
     FILE *dst;
+    int is_column_file;
 };
 
 enum ProcessArgsErrorCode {
@@ -589,28 +2486,38 @@ enum ProcessArgsErrorCode process_args(struct ParseArgsResult *args, struct Proc
     assert(result != NULL);
     assert(error != NULL);
 
-    FILE *src;
+    // The whole source is read into memory.
+    struct Buffer src = {0};
     FILE *dst;
 
     if (args->src_path == NULL) {
-        src = tmpfile();
         if (args->src_text == NULL) {
             if (file_size(stdin) == 0) {
                 error->code = PROCESS_ARGS_ERROR_NO_INPUT;
                 return PROCESS_ARGS_ERROR_NO_INPUT;
             }
-            write_file_content_to_file(stdin, src);
+            read_file_content(stdin, &src);
         } else {
-            write_string_to_file(args->src_text, src);
+            buffer_puts(&src, args->src_text);
         }
-        rewind(src);
     } else {
-        src = fopen(args->src_path, "r");
-        if (src == NULL) {
+        FILE *file = fopen(args->src_path, "rb");
+        if (file == NULL) {
             error->code = PROCESS_ARGS_ERROR_INPUT_FILE;
             error->data.file_path = args->src_path;
             return PROCESS_ARGS_ERROR_INPUT_FILE;
         }
+
+        // Column files are mapped into memory later on, so only the magic is read here.
+        char magic[8];
+        size_t magic_size = fread(magic, 1, sizeof(magic), file);
+        result->is_column_file = is_column_file(magic, magic_size);
+
+        if (!result->is_column_file) {
+            buffer_write(&src, magic, magic_size);
+            read_file_content(file, &src);
+        }
+        fclose(file);
     }
 
     if (args->dst_path == NULL) {
@@ -618,6 +2525,7 @@ enum ProcessArgsErrorCode process_args(struct ParseArgsResult *args, struct Proc
     } else {
         dst = fopen(args->dst_path, "w");
         if (dst == NULL) {
+            buffer_free(&src);
             error->code = PROCESS_ARGS_ERROR_OUTPUT_FILE;
             error->data.file_path = args->dst_path;
             return PROCESS_ARGS_ERROR_OUTPUT_FILE;
@@ -631,9 +2539,6 @@ enum ProcessArgsErrorCode process_args(struct ParseArgsResult *args, struct Proc
 }
 
 int main(int argc, char **argv) {
-    // BUG: Unclosed string causes endless loop (strings allow multiple lines currently)
-    // TODO: Add support for schemas
-
     struct ParseArgsResult parsed_args = {0}; {
         struct ParseArgsError error = {0};
         switch (parse_args(argc, argv, &parsed_args, &error)) {
@@ -647,6 +2552,46 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (parsed_args.writer_row_count > 0) {
+        // Measure the writer and the conversion of its output, no input is needed
+        return bench_writer(parsed_args.writer_row_count, stdout);
+    }
+
+#ifdef _WIN32
+    if (parsed_args.serve_path != NULL || parsed_args.connect_path != NULL || parsed_args.bench_path != NULL) {
+        fprintf(stderr, "[ERROR] The server is not supported on this platform\n");
+        return 1;
+    }
+    if (parsed_args.is_pipelined) {
+        fprintf(stderr, "[ERROR] The pipeline is not supported on this platform\n");
+        return 1;
+    }
+#else
+    if (parsed_args.serve_path != NULL) {
+        size_t thread_count = parsed_args.thread_count;
+        if (thread_count == 0) {
+            long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+            thread_count = cpu_count > 0 ? cpu_count : 1;
+        }
+
+        struct ServeError error = {0};
+        switch (serve(parsed_args.serve_path, thread_count, &error)) {
+            case SERVE_ERROR_SOCKET_PATH:
+                fprintf(stderr, "[ERROR] Socket path is too long or not a socket: %s\n", parsed_args.serve_path);
+                return 1;
+            case SERVE_ERROR_SOCKET:
+                fprintf(stderr, "[ERROR] Failed to listen on socket %s: %s\n", parsed_args.serve_path, strerror(error.data.system_error));
+                return 1;
+            case SERVE_ERROR_THREAD:
+                fprintf(stderr, "[ERROR] Failed to start the worker threads: %s\n", strerror(error.data.system_error));
+                return 1;
+            default:
+        }
+
+        return 0;
+    }
+#endif
+
     struct ProcessArgsResult processed_args = {0}; {
         struct ProcessArgsError error = {0};
         switch (process_args(&parsed_args, &processed_args, &error)) {
@@ -663,30 +2608,147 @@ int main(int argc, char **argv) {
         }
     }
 
-    FILE *src = processed_args.src;
+    struct Reader reader;
+    reader_init(&reader, processed_args.src.data, processed_args.src.size);
     FILE *dst = processed_args.dst;
-    FILE *tmp = tmpfile();
 
-    {   // Parse the source code and generate JSON output
+#ifndef _WIN32
+    if (parsed_args.connect_path != NULL) {
+        // Let the server do the conversion
+        int connection = client_connect(parsed_args.connect_path);
+        if (connection < 0) {
+            fprintf(stderr, "[ERROR] Failed to connect to socket: %s\n", parsed_args.connect_path);
+            return 1;
+        }
+
+        struct Buffer response = {0};
+        switch (client_request(connection, reader.src.data, reader.src.size, &response)) {
+            case SERVER_STATUS_OK:
+                fwrite(response.data, 1, response.size, dst);
+                break;
+            case SERVER_STATUS_ERROR:
+                fprintf(stderr, "[ERROR] %.*s\n", (int)response.size, response.data);
+                return 1;
+            default:
+                fprintf(stderr, "[ERROR] Connection to the server failed: %s\n", parsed_args.connect_path);
+                return 1;
+        }
+
+        close(connection);
+        return 0;
+    }
+
+    if (parsed_args.bench_path != NULL) {
+        // Send the same payload over and over again and measure the latencies
+        size_t request_count = parsed_args.request_count ? parsed_args.request_count : 10000;
+        // One connection per CPU by default, so that the latencies do not include queueing.
+        size_t connection_count = parsed_args.connection_count;
+        if (connection_count == 0) {
+            long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+            connection_count = cpu_count > 0 ? cpu_count : 1;
+        }
+        bench(parsed_args.bench_path, &processed_args.src, request_count, connection_count, dst);
+        return 0;
+    }
+#endif
+
+#ifndef _WIN32
+    // Column files are not lexed, so they do not need the lexer thread.
+    struct Pipeline pipeline;
+    int is_pipelined = 0;
+    if (parsed_args.is_pipelined && !processed_args.is_column_file) {
+        is_pipelined = pipeline_start(&pipeline, &reader, parsed_args.batch_size ? parsed_args.batch_size : PIPELINE_DEFAULT_BATCH_SIZE);
+    }
+#endif
+
+    uint64_t start_time = monotonic_nanoseconds();
+    size_t byte_count = reader.src.size;
+
+    if (parsed_args.columns_path != NULL) {
+        // Load the schema lists as tables and dump them as columns
+        FILE *columns = fopen(parsed_args.columns_path, "wb");
+        if (columns == NULL) {
+            fprintf(stderr, "[ERROR] Failed to open columns file for writing: %s\n", parsed_args.columns_path);
+            return 1;
+        }
+
+        struct TableList tables = {0};
         struct ProcessError error = {0};
-        switch (process_record(src, tmp, 1, &error)) {
-            case PROCESS_ERROR_UNEXPECTED_EOF:
-                fprintf(
-                    stderr, "[ERROR] Unexpected EOF after token: %s (ln: %llu, col: %llu}\n",
-                    token_type_to_string(error.token.type), error.token.line, error.token.col
-                );
+        if (load_tables(&reader, &tables, &error)) {
+            print_process_error(&error);
+            return 1;
+        }
+
+        enum ColumnFileErrorCode result = column_file_write(columns, &tables);
+        table_list_free(&tables);
+        if (fclose(columns) != 0 || result != COLUMN_FILE_ERROR_NONE) {
+            fprintf(stderr, "[ERROR] Failed to write columns file: %s\n", parsed_args.columns_path);
+            return 1;
+        }
+    }
+
+    else if (processed_args.is_column_file) {
+        // Convert the tables of a column file back into JSON
+        struct ColumnFile file = {0};
+        struct ColumnFileError error = {0};
+        switch (column_file_open(parsed_args.src_path, &file, &error)) {
+            case COLUMN_FILE_ERROR_OPEN:
+                fprintf(stderr, "[ERROR] Failed to open input file for reading: %s\n", parsed_args.src_path);
                 return 1;
-            case PROCESS_ERROR_UNEXPECTED_TOKEN:
-                fprintf(
-                    stderr, "[ERROR] Unexpected token: %s (ln: %llu, col: %llu}\n",
-                    token_type_to_string(error.token.type), error.token.line, error.token.col
-                );
+            case COLUMN_FILE_ERROR_BYTE_ORDER:
+                fprintf(stderr, "[ERROR] Columns file was written with another byte order: %s\n", parsed_args.src_path);
+                return 1;
+            case COLUMN_FILE_ERROR_INVALID_HEADER:
+            case COLUMN_FILE_ERROR_INVALID_LAYOUT:
+                fprintf(stderr, "[ERROR] Invalid columns file: %s\n", parsed_args.src_path);
                 return 1;
             default:
         }
+
+        byte_count = file.size;
+        column_file_write_json(&file, dst);
+        column_file_close(&file);
+    }
+    else {   // Parse the source code and generate JSON output
+        // The output is only written once the whole source has been converted.
+        struct Buffer output = {0};
+        struct ProcessError error = {0};
+        if (process_record(&reader, &output, 1, &error)) {
+            print_process_error(&error);
+            return 1;
+        }
+        fwrite(output.data, 1, output.size, dst);
+    }
+
+    uint64_t elapsed_time = monotonic_nanoseconds() - start_time;
+
+#ifndef _WIN32
+    if (is_pipelined) {
+        pipeline_stop(&pipeline);
+    }
+#endif
+
+    if (parsed_args.is_stats_enabled) {
+        // Print the statistics to stderr, so that they do not mix with the output
+        size_t token_count = reader.token_count;
+        fprintf(stderr, "[STATS] bytes:    %zu\n", byte_count);
+#ifndef _WIN32
+        if (is_pipelined) {
+            token_count = pipeline.token_count;
+        }
+#endif
+        fprintf(stderr, "[STATS] tokens:   %zu\n", token_count);
+        fprintf(stderr, "[STATS] time:     %.3f ms (%.1f MB/s)\n", elapsed_time / 1e6, byte_count / (elapsed_time / 1e9) / 1e6);
+#ifndef _WIN32
+        if (is_pipelined) {
+            fprintf(
+                stderr, "[STATS] pipeline: batch size %zu, %zu batches, %zu lexer stalls, %zu parser stalls\n",
+                pipeline.batch_size, pipeline.batch_count, pipeline.lexer_stall_count, pipeline.parser_stall_count
+            );
+        }
+#endif
     }
 
-    write_file_content_to_file(tmp, dst);
     // TODO: Close the opened files? (not necessary)
 
     return 0;
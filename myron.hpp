@@ -0,0 +1,688 @@
+// Header-only C++17 bindings for myron.
+//
+// Deserializes myron directly into user structs, without an intermediate DOM or JSON.
+// The fields of a struct are described once with MYRON_FIELDS:
+//
+//     struct Person {
+//         std::string name;
+//         int age;
+//     };
+//     MYRON_FIELDS(Person, name, age)
+//
+//     struct People {
+//         std::vector<Person> people;
+//     };
+//     MYRON_FIELDS(People, people)
+//
+//     People people = myron::parse<People>(text);
+//
+// Supported field types are bool, integers, floating point numbers, std::string,
+// std::vector and structs with MYRON_FIELDS. Vectors of structs can be written as
+// schema lists, e.g. people (name age) [ "Alice" 45 "Bob" 30 ]. Unknown keys are skipped.
+//
+// Keys are matched through a perfect hash that is generated at compile time
+// for every struct, so a key is looked up with one hash and one comparison.
+// Errors are thrown as myron::ParseError, and as myron::WriteError when writing.
+//
+// The same structs can be written back with myron::to_string or myron::Writer.
+
+#ifndef MYRON_HPP
+#define MYRON_HPP
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "myron_lexer.h"
+#include "myron_writer.h"
+
+namespace myron {
+
+// LEXER
+//
+// The lexer of myron_lexer.h, which is shared with myron.c.
+
+using ::TokenType;
+using ::Token;
+using ::token_type_to_string;
+
+class ParseError : public std::runtime_error {
+public:
+    ParseError(const char *description, const Token &token)
+        : std::runtime_error(
+            std::string(description) + ": " + token_type_to_string(token.type) +
+            " (ln: " + std::to_string(token.line) + ", col: " + std::to_string(token.col) + ")"
+        ),
+          token(token) {}
+
+    Token token;
+};
+
+class Source {
+public:
+    explicit Source(std::string_view data) {
+        source_init(&src, data.data(), data.size());
+    }
+
+    // Reads the next token, returns false at EOF.
+    // At EOF only the position of the token is updated.
+    bool next(Token &token) {
+        return token_next(&src, &token);
+    }
+
+    std::string_view slice(const Token &token) const {
+        return std::string_view(src.data + token.start, token.end - token.start);
+    }
+
+private:
+    ::Source src;
+};
+
+// Resolves the escapes of a string without its quotes, see string_unescape in myron_lexer.h.
+// Returns false if an escape is invalid.
+inline bool unescape(std::string_view value, std::string &out) {
+    size_t start = out.size();
+    size_t size = 0;
+
+    out.resize(start + value.size());
+    if (!string_unescape(value.data(), value.size(), out.data() + start, &size)) {
+        out.resize(start);
+        return false;
+    }
+    out.resize(start + size);
+
+    return true;
+}
+
+// FIELDS
+
+template <class T, class M>
+struct Field {
+    std::string_view name;
+    M T::*member;
+};
+
+// FNV-1a
+constexpr uint64_t hash(std::string_view key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char byte : key) {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Finds the smallest table size for which every hash lands in its own slot.
+// Returns 0 if there is no such size within the limit.
+template <size_t N>
+constexpr size_t perfect_hash_size(const std::array<uint64_t, N> &hashes) {
+    for (size_t size = N ? N : 1; size <= N * 16 + 16; size += 1) {
+        bool is_perfect = true;
+        for (size_t i = 0; i < N && is_perfect; i += 1) {
+            for (size_t j = i + 1; j < N && is_perfect; j += 1) {
+                is_perfect = hashes[i] % size != hashes[j] % size;
+            }
+        }
+        if (is_perfect) {
+            return size;
+        }
+    }
+    return 0;
+}
+
+template <class T, class = void>
+struct has_fields : std::false_type {};
+
+template <class T>
+struct has_fields<T, std::void_t<decltype(myron_fields(static_cast<const T*>(nullptr)))>> : std::true_type {};
+
+template <class T>
+struct is_vector : std::false_type {};
+
+template <class T, class A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+// The compile-time key table of a struct with MYRON_FIELDS.
+template <class T>
+struct Fields {
+    static constexpr auto list = myron_fields(static_cast<const T*>(nullptr));
+    static constexpr size_t count = std::tuple_size_v<std::decay_t<decltype(list)>>;
+
+    template <size_t... I>
+    static constexpr std::array<std::string_view, count> make_names(std::index_sequence<I...>) {
+        return {{std::get<I>(list).name...}};
+    }
+
+    static constexpr std::array<std::string_view, count> names = make_names(std::make_index_sequence<count>());
+
+    static constexpr std::array<uint64_t, count> make_hashes() {
+        std::array<uint64_t, count> hashes = {};
+        for (size_t i = 0; i < count; i += 1) {
+            hashes[i] = hash(names[i]);
+        }
+        return hashes;
+    }
+
+    static constexpr std::array<uint64_t, count> hashes = make_hashes();
+    static constexpr size_t size = perfect_hash_size(hashes);
+    static_assert(size != 0, "myron: no perfect hash for the field names, are there duplicate fields?");
+
+    // Every slot holds the index of a field, or count if the slot is empty.
+    static constexpr std::array<size_t, size> make_slots() {
+        std::array<size_t, size> slots = {};
+        for (size_t i = 0; i < size; i += 1) {
+            slots[i] = count;
+        }
+        for (size_t i = 0; i < count; i += 1) {
+            slots[hashes[i] % size] = i;
+        }
+        return slots;
+    }
+
+    static constexpr std::array<size_t, size> slots = make_slots();
+
+    // Returns the index of the field with the key, or count if there is none.
+    static size_t find(std::string_view key) {
+        size_t index = slots[hash(key) % size];
+        return index < count && names[index] == key ? index : count;
+    }
+};
+
+// PARSER
+
+class Parser {
+public:
+    explicit Parser(std::string_view data) : src(data) {}
+
+    template <class T>
+    void parse_root(T &out) {
+        static_assert(has_fields<T>::value, "myron: the root type needs MYRON_FIELDS");
+        read_record(out, true);
+    }
+
+private:
+    // Reads the next token that is not whitespace, returns false at EOF.
+    // At EOF the token has the EOF position and the type of the last token, see token_next.
+    bool read(Token &token) {
+        while (src.next(token)) {
+            if (token.type != TT_WSPACE && token.type != TT_NEWLIN) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[noreturn]] void fail(const char *description, const Token &token) {
+        throw ParseError(description, token);
+    }
+
+    static bool is_value(TokenType type) {
+        switch (type) {
+            case TT_IDENTI:
+            case TT_STRING:
+            case TT_NUMBER:
+            case TT_LPAREN:
+            case TT_LBRACE:
+            case TT_LBRACK:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    Token read_value_token() {
+        Token token = {};
+        if (!read(token)) {
+            fail("Unexpected EOF after token", token);
+        }
+        if (!is_value(token.type)) {
+            fail("Unexpected token", token);
+        }
+        return token;
+    }
+
+    template <class T>
+    void read_record(T &out, bool is_root_record) {
+        Token key = {};
+        for (;;) {
+            if (!read(key)) {
+                if (!is_root_record) {
+                    fail("Unexpected EOF after token", key);
+                }
+                return;
+            }
+            if (key.type == TT_RBRACE) {
+                return;
+            }
+            if (key.type != TT_IDENTI) {
+                fail("Unexpected token", key);
+            }
+
+            Token value = read_value_token();
+            read_field(out, Fields<T>::find(src.slice(key)), value);
+        }
+    }
+
+    // Reads the value into the field at the index, or skips it if there is no such field.
+    template <class T>
+    void read_field(T &out, size_t index, const Token &token) {
+        read_field(out, index, token, std::make_index_sequence<Fields<T>::count>());
+    }
+
+    template <class T, size_t... I>
+    void read_field(T &out, size_t index, const Token &token, std::index_sequence<I...>) {
+        bool is_found = ((index == I ? (read_value(token, out.*(std::get<I>(Fields<T>::list).member)), true) : false) || ...);
+        if (!is_found) {
+            skip_value(token);
+        }
+    }
+
+    // Maps the schema keys to field indices.
+    template <class T>
+    std::vector<size_t> read_schema() {
+        std::vector<size_t> columns;
+        Token token = {};
+        for (;;) {
+            if (!read(token)) {
+                fail("Unexpected EOF after token", token);
+            }
+            if (token.type == TT_RPAREN) {
+                return columns;
+            }
+            if (token.type != TT_IDENTI) {
+                fail("Unexpected token", token);
+            }
+            if constexpr (has_fields<T>::value) {
+                columns.push_back(Fields<T>::find(src.slice(token)));
+            } else {
+                columns.push_back(0);
+            }
+        }
+    }
+
+    // Reads the rows of a schema list or a schema record.
+    // Every row is passed to the callback, which returns the struct to read the row into.
+    template <class T, class NextRow>
+    void read_schema_rows(const std::vector<size_t> &columns, TokenType terminator, NextRow next_row) {
+        size_t column = 0;
+        size_t row = 0;
+        T *out = nullptr;
+        Token token = {};
+
+        for (;;) {
+            if (!read(token)) {
+                fail("Unexpected EOF after token", token);
+            }
+            if (token.type == terminator && column == 0) {
+                return;
+            }
+            // A schema record can only hold a single row of values.
+            if (!is_value(token.type) || columns.empty() || (terminator == TT_RBRACE && row == 1)) {
+                fail("Unexpected token", token);
+            }
+
+            if (column == 0) {
+                out = &next_row();
+            }
+            read_field(*out, columns[column], token);
+
+            column += 1;
+            if (column == columns.size()) {
+                column = 0;
+                row += 1;
+            }
+        }
+    }
+
+    template <class T>
+    void read_value(const Token &token, T &out) {
+        if constexpr (std::is_same_v<T, bool>) {
+            std::string_view value = src.slice(token);
+            if (token.type != TT_IDENTI || (value != "true" && value != "false")) {
+                fail("Unexpected token", token);
+            }
+            out = value == "true";
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            if (token.type != TT_NUMBER) {
+                fail("Unexpected token", token);
+            }
+            read_number(token, out);
+        }
+        else if constexpr (std::is_same_v<T, std::string>) {
+            if (token.type != TT_STRING) {
+                fail("Unexpected token", token);
+            }
+            std::string_view value = src.slice(token);
+            out.clear();
+            if (!unescape(value.substr(1, value.size() - 2), out)) {
+                fail("Invalid string escape", token);
+            }
+        }
+        else if constexpr (is_vector<T>::value) {
+            using Element = typename T::value_type;
+            // A list replaces the elements, just like a string replaces the characters.
+            out.clear();
+            if (token.type == TT_LBRACK) {
+                Token element = {};
+                for (;;) {
+                    if (!read(element)) {
+                        fail("Unexpected EOF after token", element);
+                    }
+                    if (element.type == TT_RBRACK) {
+                        return;
+                    }
+                    if (!is_value(element.type)) {
+                        fail("Unexpected token", element);
+                    }
+                    read_value(element, out.emplace_back());
+                }
+            }
+            else if constexpr (has_fields<Element>::value) {
+                if (token.type != TT_LPAREN) {
+                    fail("Unexpected token", token);
+                }
+                std::vector<size_t> columns = read_schema<Element>();
+                Token list = read_value_token();
+                if (list.type != TT_LBRACK) {
+                    fail("Unexpected token", list);
+                }
+                read_schema_rows<Element>(columns, TT_RBRACK, [&]() -> Element& { return out.emplace_back(); });
+            }
+            else {
+                fail("Unexpected token", token);
+            }
+        }
+        else if constexpr (has_fields<T>::value) {
+            if (token.type == TT_LBRACE) {
+                read_record(out, false);
+            }
+            else if (token.type == TT_LPAREN) {
+                std::vector<size_t> columns = read_schema<T>();
+                Token record = read_value_token();
+                if (record.type != TT_LBRACE) {
+                    fail("Unexpected token", record);
+                }
+                read_schema_rows<T>(columns, TT_RBRACE, [&]() -> T& { return out; });
+            }
+            else {
+                fail("Unexpected token", token);
+            }
+        }
+        else {
+            static_assert(has_fields<T>::value, "myron: unsupported field type, does it need MYRON_FIELDS?");
+        }
+    }
+
+    // Numbers can have underscores as digit separators.
+    template <class T>
+    void read_number(const Token &token, T &out) {
+        char buffer[64];
+        size_t size = 0;
+
+        for (char byte : src.slice(token)) {
+            if (byte == '_') {
+                continue;
+            }
+            if (size == sizeof(buffer) - 1) {
+                fail("Invalid number", token);
+            }
+            buffer[size++] = byte;
+        }
+        buffer[size] = '\0';
+
+        // Unlike strtod, from_chars does not depend on the locale.
+        auto result = std::from_chars(buffer, buffer + size, out);
+        if (result.ec != std::errc() || result.ptr != buffer + size) {
+            fail("Invalid number", token);
+        }
+    }
+
+    // Validates a value that has no field to go into, like myron.c does when converting it.
+    // Number tokens are valid numbers already, the lexer only produces those.
+    void skip_value(const Token &token) {
+        switch (token.type) {
+            case TT_IDENTI: {
+                bool value;
+                read_value(token, value);
+            } break;
+            case TT_STRING: {
+                std::string_view value = src.slice(token);
+                if (!string_unescape(value.data() + 1, value.size() - 2, nullptr, nullptr)) {
+                    fail("Invalid string escape", token);
+                }
+            } break;
+            case TT_LBRACE: {
+                Token key = {};
+                for (;;) {
+                    if (!read(key)) {
+                        fail("Unexpected EOF after token", key);
+                    }
+                    if (key.type == TT_RBRACE) {
+                        return;
+                    }
+                    if (key.type != TT_IDENTI) {
+                        fail("Unexpected token", key);
+                    }
+                    skip_value(read_value_token());
+                }
+            }
+            case TT_LBRACK: {
+                Token element = {};
+                for (;;) {
+                    if (!read(element)) {
+                        fail("Unexpected EOF after token", element);
+                    }
+                    if (element.type == TT_RBRACK) {
+                        return;
+                    }
+                    if (!is_value(element.type)) {
+                        fail("Unexpected token", element);
+                    }
+                    skip_value(element);
+                }
+            }
+            case TT_LPAREN: {
+                std::vector<size_t> columns = read_schema<Skipped>();
+                Token value = read_value_token();
+                if (value.type != TT_LBRACK && value.type != TT_LBRACE) {
+                    fail("Unexpected token", value);
+                }
+                // Every key of an empty struct is unknown, so all values are skipped.
+                Skipped skipped;
+                read_schema_rows<Skipped>(columns, value.type == TT_LBRACK ? TT_RBRACK : TT_RBRACE, [&]() -> Skipped& { return skipped; });
+            } break;
+            default:
+                break;
+        }
+    }
+
+    struct Skipped {};
+    friend constexpr std::tuple<> myron_fields(const Skipped*) { return {}; }
+
+    Source src;
+};
+
+template <class T>
+void parse(std::string_view text, T &out) {
+    Parser parser(text);
+    parser.parse_root(out);
+}
+
+template <class T>
+T parse(std::string_view text) {
+    T out{};
+    parse(text, out);
+    return out;
+}
+
+// WRITER
+//
+// Wraps the C writer of myron_writer.h. Structs with MYRON_FIELDS are written as records,
+// and vectors of them come out as schema lists.
+
+class WriteError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class Writer {
+public:
+    // Without a file the output stays in the buffer, see str().
+    explicit Writer(FILE *file = nullptr) {
+        myron_writer_init(&writer, file);
+    }
+
+    ~Writer() {
+        myron_writer_free(&writer);
+    }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    void key(std::string_view key) {
+        if (!myron_write_key_n(&writer, key.data(), key.size())) {
+            throw WriteError("myron: keys must be identifiers");
+        }
+    }
+
+    template <class T>
+    void value(const T &value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            myron_write_boolean(&writer, value);
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            myron_write_integer(&writer, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            if (!myron_write_float(&writer, static_cast<double>(value))) {
+                throw WriteError("myron: NaN and infinity can not be written");
+            }
+        }
+        else if constexpr (std::is_convertible_v<const T &, std::string_view>) {
+            std::string_view string = value;
+            myron_write_string_n(&writer, string.data(), string.size());
+        }
+        else if constexpr (is_vector<T>::value) {
+            begin_list();
+            for (const auto &element : value) {
+                this->value(element);
+            }
+            end_list();
+        }
+        else if constexpr (has_fields<T>::value) {
+            begin_record();
+            fields(value);
+            end_record();
+        }
+        else {
+            static_assert(has_fields<T>::value, "myron: unsupported field type, does it need MYRON_FIELDS?");
+        }
+    }
+
+    // Writes the fields of the struct as key-value pairs.
+    template <class T>
+    void fields(const T &value) {
+        std::apply([&](const auto &... field) {
+            ((key(field.name), this->value(value.*(field.member))), ...);
+        }, Fields<T>::list);
+    }
+
+    void begin_record() { myron_begin_record(&writer); }
+    void end_record() { myron_end_record(&writer); }
+    void begin_list() { myron_begin_list(&writer); }
+    void end_list() { myron_end_list(&writer); }
+    void end_table() { myron_end_table(&writer); }
+
+    void begin_table(const std::vector<const char*> &columns) {
+        if (!myron_begin_table(&writer, columns.data(), columns.size())) {
+            throw WriteError("myron: keys must be identifiers");
+        }
+    }
+
+    void flush() {
+        if (!myron_writer_flush(&writer)) {
+            throw WriteError("myron: failed to write the output");
+        }
+    }
+
+    std::string_view str() const {
+        return std::string_view(writer.data, writer.size);
+    }
+
+    MyronWriter *get() { return &writer; }
+
+private:
+    MyronWriter writer;
+};
+
+// Writes the fields of the struct as the root record.
+template <class T>
+std::string to_string(const T &root) {
+    static_assert(has_fields<T>::value, "myron: the root type needs MYRON_FIELDS");
+    Writer writer;
+    writer.fields(root);
+    return std::string(writer.str());
+}
+
+} // namespace myron
+
+// MYRON_FIELDS(Type, fields...) describes the fields of a struct, up to 32 of them.
+// It has to be used in the namespace of the struct.
+
+#define MYRON_EXPAND(x) x
+
+#define MYRON_FIELD(Type, name) ::myron::Field<Type, decltype(Type::name)>{#name, &Type::name}
+
+#define MYRON_FOR_EACH_1(Macro, Type, x) Macro(Type, x)
+#define MYRON_FOR_EACH_2(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_1(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_3(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_2(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_4(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_3(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_5(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_4(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_6(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_5(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_7(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_6(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_8(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_7(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_9(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_8(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_10(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_9(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_11(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_10(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_12(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_11(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_13(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_12(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_14(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_13(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_15(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_14(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_16(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_15(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_17(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_16(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_18(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_17(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_19(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_18(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_20(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_19(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_21(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_20(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_22(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_21(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_23(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_22(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_24(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_23(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_25(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_24(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_26(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_25(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_27(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_26(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_28(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_27(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_29(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_28(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_30(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_29(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_31(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_30(Macro, Type, __VA_ARGS__))
+#define MYRON_FOR_EACH_32(Macro, Type, x, ...) Macro(Type, x), MYRON_EXPAND(MYRON_FOR_EACH_31(Macro, Type, __VA_ARGS__))
+
+#define MYRON_FOR_EACH_SELECT(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, Name, ...) Name
+#define MYRON_FOR_EACH(Macro, Type, ...) MYRON_EXPAND(MYRON_FOR_EACH_SELECT(__VA_ARGS__, MYRON_FOR_EACH_32, MYRON_FOR_EACH_31, MYRON_FOR_EACH_30, MYRON_FOR_EACH_29, MYRON_FOR_EACH_28, MYRON_FOR_EACH_27, MYRON_FOR_EACH_26, MYRON_FOR_EACH_25, MYRON_FOR_EACH_24, MYRON_FOR_EACH_23, MYRON_FOR_EACH_22, MYRON_FOR_EACH_21, MYRON_FOR_EACH_20, MYRON_FOR_EACH_19, MYRON_FOR_EACH_18, MYRON_FOR_EACH_17, MYRON_FOR_EACH_16, MYRON_FOR_EACH_15, MYRON_FOR_EACH_14, MYRON_FOR_EACH_13, MYRON_FOR_EACH_12, MYRON_FOR_EACH_11, MYRON_FOR_EACH_10, MYRON_FOR_EACH_9, MYRON_FOR_EACH_8, MYRON_FOR_EACH_7, MYRON_FOR_EACH_6, MYRON_FOR_EACH_5, MYRON_FOR_EACH_4, MYRON_FOR_EACH_3, MYRON_FOR_EACH_2, MYRON_FOR_EACH_1, ~)(Macro, Type, __VA_ARGS__))
+
+#define MYRON_FIELDS(Type, ...) \
+    [[maybe_unused]] constexpr auto myron_fields(const Type*) { \
+        return std::make_tuple(MYRON_FOR_EACH(MYRON_FIELD, Type, __VA_ARGS__)); \
+    }
+
+#endif
@@ -0,0 +1,343 @@
+// Header-only reader for myron column files, for C and C++.
+//
+// `myron -i data.myron -c data.myrcol` loads the schema lists at the root of a
+// document as tables of columns and dumps them into a column file. The file is
+// mapped into memory and used as is, so scanning a column is a loop over an array:
+//
+//     struct ColumnFile file = {0};
+//     struct ColumnFileError error = {0};
+//     if (column_file_open("data.myrcol", &file, &error) != COLUMN_FILE_ERROR_NONE) {
+//         ...
+//     }
+//
+//     const struct ColumnFileTable *table = column_file_find_table(&file, "people");
+//     const struct ColumnFileColumn *age = column_file_find_column(&file, table, "age");
+//     if (age != NULL && age->type == COLUMN_TYPE_INTEGER) {
+//         const int64_t *ages = column_file_integers(&file, age);
+//         for (uint64_t row = 0; row < table->row_count; row += 1) {
+//             sum += ages[row];
+//         }
+//     }
+//
+//     column_file_close(&file);
+//
+// The reader is written in the common subset of C and C++.
+
+#ifndef MYRON_COLUMNS_H
+#define MYRON_COLUMNS_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+enum ColumnType {
+    COLUMN_TYPE_UNDEFN,
+    COLUMN_TYPE_INTEGER,
+    COLUMN_TYPE_FLOAT,
+    COLUMN_TYPE_BOOLEAN,
+    COLUMN_TYPE_STRING,
+};
+
+// FILE FORMAT
+//
+// A column file is a flat dump of a table list that can be mapped into memory
+// and used as is. All integers are in the byte order of the machine that wrote
+// the file, which the header records, and every section starts at an offset
+// that is a multiple of 8. Offsets are relative to the start of the file.
+//
+//     header
+//     table descriptors   (header.table_count)
+//     column descriptors  (table.column_count per table, at table.columns_offset)
+//     names and data
+//
+// Integer columns are int64 arrays, float columns double arrays and boolean
+// columns uint8 arrays, all with row_count elements. String columns have an
+// uint64 array of row_count + 1 offsets into a blob of the string values, escapes resolved.
+
+#define COLUMN_FILE_MAGIC "MYRONCOL"
+#define COLUMN_FILE_VERSION 3
+
+// Written as a native uint32, so that it reads back as 0x04030201 with the other byte order.
+#define COLUMN_FILE_BYTE_ORDER 0x01020304u
+
+struct ColumnFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t table_count;
+    uint32_t reserved;
+    uint64_t tables_offset;
+};
+
+struct ColumnFileTable {
+    uint64_t name_offset;
+    uint64_t name_size;
+    uint64_t row_count;
+    uint64_t column_count;
+    uint64_t columns_offset;
+};
+
+struct ColumnFileColumn {
+    uint64_t name_offset;
+    uint64_t name_size;
+    uint32_t type; // enum ColumnType
+    uint32_t reserved;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t blob_offset;
+    uint64_t blob_size;
+};
+
+enum ColumnFileErrorCode {
+    COLUMN_FILE_ERROR_NONE,
+    COLUMN_FILE_ERROR_OPEN,
+    COLUMN_FILE_ERROR_WRITE,
+    COLUMN_FILE_ERROR_INVALID_HEADER,
+    COLUMN_FILE_ERROR_BYTE_ORDER,
+    COLUMN_FILE_ERROR_INVALID_LAYOUT,
+};
+
+struct ColumnFileError {
+    enum ColumnFileErrorCode code;
+};
+
+// READER
+
+struct ColumnFile {
+    const char *data;
+    size_t size;
+    int is_mapped;
+    const struct ColumnFileHeader *header;
+    const struct ColumnFileTable *tables;
+};
+
+static inline int is_column_file(const char *data, size_t size) {
+    return size >= 8 && !memcmp(data, COLUMN_FILE_MAGIC, 8);
+}
+
+static inline int column_file_contains(const struct ColumnFile *file, uint64_t offset, uint64_t size) {
+    return offset <= file->size && size <= file->size - offset;
+}
+
+// Checks that every descriptor and every section lies within the file,
+// so that the columns can be accessed without any further checks.
+static inline enum ColumnFileErrorCode column_file_validate(struct ColumnFile *file) {
+    assert(file != NULL);
+
+    if (file->size < sizeof(struct ColumnFileHeader)) {
+        return COLUMN_FILE_ERROR_INVALID_HEADER;
+    }
+
+    const struct ColumnFileHeader *header = (const struct ColumnFileHeader*)file->data;
+    if (memcmp(header->magic, COLUMN_FILE_MAGIC, sizeof(header->magic))) {
+        return COLUMN_FILE_ERROR_INVALID_HEADER;
+    }
+    if (header->byte_order == 0x04030201u) {
+        return COLUMN_FILE_ERROR_BYTE_ORDER;
+    }
+    if (header->byte_order != COLUMN_FILE_BYTE_ORDER || header->version != COLUMN_FILE_VERSION) {
+        return COLUMN_FILE_ERROR_INVALID_HEADER;
+    }
+
+    if (header->tables_offset % 8 || !column_file_contains(file, header->tables_offset, (uint64_t)header->table_count * sizeof(struct ColumnFileTable))) {
+        return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+    }
+
+    const struct ColumnFileTable *tables = (const struct ColumnFileTable*)(file->data + header->tables_offset);
+
+    for (uint32_t i = 0; i < header->table_count; i += 1) {
+        const struct ColumnFileTable *table = &tables[i];
+
+        if (
+            !column_file_contains(file, table->name_offset, table->name_size) ||
+            table->columns_offset % 8 ||
+            table->column_count > file->size / sizeof(struct ColumnFileColumn) ||
+            !column_file_contains(file, table->columns_offset, table->column_count * sizeof(struct ColumnFileColumn))
+        ) {
+            return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+        }
+
+        const struct ColumnFileColumn *columns = (const struct ColumnFileColumn*)(file->data + table->columns_offset);
+
+        for (uint64_t j = 0; j < table->column_count; j += 1) {
+            const struct ColumnFileColumn *column = &columns[j];
+            uint64_t data_size;
+
+            switch (column->type) {
+                case COLUMN_TYPE_INTEGER:
+                case COLUMN_TYPE_FLOAT:
+                    data_size = table->row_count * 8;
+                    break;
+                case COLUMN_TYPE_BOOLEAN:
+                    data_size = table->row_count;
+                    break;
+                case COLUMN_TYPE_STRING:
+                    data_size = (table->row_count + 1) * 8;
+                    break;
+                case COLUMN_TYPE_UNDEFN:
+                    data_size = 0;
+                    if (table->row_count != 0) {
+                        return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+                    }
+                    break;
+                default:
+                    return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+            }
+
+            if (
+                table->row_count > file->size ||
+                column->data_size != data_size ||
+                column->data_offset % 8 ||
+                !column_file_contains(file, column->name_offset, column->name_size) ||
+                !column_file_contains(file, column->data_offset, column->data_size) ||
+                !column_file_contains(file, column->blob_offset, column->blob_size)
+            ) {
+                return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+            }
+
+            if (column->type == COLUMN_TYPE_STRING) {
+                const uint64_t *offsets = (const uint64_t*)(file->data + column->data_offset);
+                for (uint64_t k = 0; k < table->row_count; k += 1) {
+                    if (offsets[k] > offsets[k + 1] || offsets[k + 1] > column->blob_size) {
+                        return COLUMN_FILE_ERROR_INVALID_LAYOUT;
+                    }
+                }
+            }
+        }
+    }
+
+    file->header = header;
+    file->tables = tables;
+
+    return COLUMN_FILE_ERROR_NONE;
+}
+
+static inline enum ColumnFileErrorCode column_file_open(const char *path, struct ColumnFile *file, struct ColumnFileError *error) {
+    assert(path != NULL);
+    assert(file != NULL);
+    assert(error != NULL);
+
+    FILE *src = fopen(path, "rb");
+    if (src == NULL) {
+        error->code = COLUMN_FILE_ERROR_OPEN;
+        return COLUMN_FILE_ERROR_OPEN;
+    }
+
+    fseek(src, 0, SEEK_END);
+    file->size = ftell(src);
+    rewind(src);
+
+#ifndef _WIN32
+    void *data = file->size ? mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fileno(src), 0) : MAP_FAILED;
+    if (data != MAP_FAILED) {
+        file->data = (const char*)data;
+        file->is_mapped = 1;
+    }
+#endif
+
+    // Fall back to reading the whole file into memory.
+    if (!file->is_mapped) {
+        char *data = (char*)malloc(file->size ? file->size : 1);
+        assert(data != NULL);
+        file->size = fread(data, 1, file->size, src);
+        file->data = data;
+    }
+
+    fclose(src);
+
+    error->code = column_file_validate(file);
+    return error->code;
+}
+
+static inline void column_file_close(struct ColumnFile *file) {
+    assert(file != NULL);
+
+#ifndef _WIN32
+    if (file->is_mapped) {
+        munmap((void*)file->data, file->size);
+    } else {
+        free((void*)file->data);
+    }
+#else
+    free((void*)file->data);
+#endif
+
+    memset(file, 0, sizeof(*file));
+}
+
+// ACCESS
+//
+// The file must be validated, which column_file_open does. The arrays are
+// only valid for columns of the matching type, and while the file is open.
+
+static inline const struct ColumnFileColumn *column_file_columns(const struct ColumnFile *file, const struct ColumnFileTable *table) {
+    return (const struct ColumnFileColumn*)(file->data + table->columns_offset);
+}
+
+// Returns NULL if there is no table with the name.
+static inline const struct ColumnFileTable *column_file_find_table(const struct ColumnFile *file, const char *name) {
+    assert(file != NULL);
+    assert(name != NULL);
+
+    size_t size = strlen(name);
+    for (uint32_t i = 0; i < file->header->table_count; i += 1) {
+        const struct ColumnFileTable *table = &file->tables[i];
+        if (table->name_size == size && !memcmp(file->data + table->name_offset, name, size)) {
+            return table;
+        }
+    }
+    return NULL;
+}
+
+// Returns NULL if the table is NULL or has no column with the name.
+static inline const struct ColumnFileColumn *column_file_find_column(const struct ColumnFile *file, const struct ColumnFileTable *table, const char *name) {
+    assert(file != NULL);
+    assert(name != NULL);
+
+    if (table == NULL) {
+        return NULL;
+    }
+
+    const struct ColumnFileColumn *columns = column_file_columns(file, table);
+    size_t size = strlen(name);
+    for (uint64_t i = 0; i < table->column_count; i += 1) {
+        if (columns[i].name_size == size && !memcmp(file->data + columns[i].name_offset, name, size)) {
+            return &columns[i];
+        }
+    }
+    return NULL;
+}
+
+static inline const int64_t *column_file_integers(const struct ColumnFile *file, const struct ColumnFileColumn *column) {
+    assert(column->type == COLUMN_TYPE_INTEGER);
+    return (const int64_t*)(file->data + column->data_offset);
+}
+
+static inline const double *column_file_floats(const struct ColumnFile *file, const struct ColumnFileColumn *column) {
+    assert(column->type == COLUMN_TYPE_FLOAT);
+    return (const double*)(file->data + column->data_offset);
+}
+
+static inline const uint8_t *column_file_booleans(const struct ColumnFile *file, const struct ColumnFileColumn *column) {
+    assert(column->type == COLUMN_TYPE_BOOLEAN);
+    return (const uint8_t*)(file->data + column->data_offset);
+}
+
+// Returns the string value of the row, which is not NUL terminated.
+static inline const char *column_file_string(const struct ColumnFile *file, const struct ColumnFileColumn *column, uint64_t row, size_t *size) {
+    assert(column->type == COLUMN_TYPE_STRING);
+    assert(size != NULL);
+
+    const uint64_t *offsets = (const uint64_t*)(file->data + column->data_offset);
+    *size = offsets[row + 1] - offsets[row];
+    return file->data + column->blob_offset + offsets[row];
+}
+
+#endif
@@ -0,0 +1,480 @@
+// The myron lexer, shared by myron.c and myron.hpp.
+//
+// The whole source text is kept in memory, and tokens refer to it by their
+// start and end positions:
+//
+//     struct Source src;
+//     struct Token token;
+//     source_init(&src, text, size);
+//     while (token_next(&src, &token)) {
+//         ...
+//     }
+//
+// The lexer is written in the common subset of C and C++.
+
+#ifndef MYRON_LEXER_H
+#define MYRON_LEXER_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// CHARACTER CLASSES
+//
+// The lexer looks up the class of every byte in a table instead of testing the byte
+// against ranges. The classes that continue an identifier (CC_ALPHA to CC_UNDERSCORE)
+// and a number (CC_DIGIT and CC_UNDERSCORE) are kept together.
+
+enum CharClass {
+    CC_OTHER,
+    CC_ALPHA,
+    CC_EXPONENT,
+    CC_DIGIT,
+    CC_UNDERSCORE,
+    CC_SPACE,
+    CC_NEWLINE,
+    CC_HASH,
+    CC_QUOTE,
+    CC_MINUS,
+    CC_LPAREN,
+    CC_RPAREN,
+    CC_LBRACE,
+    CC_RBRACE,
+    CC_LBRACK,
+    CC_RBRACK,
+    CC_COUNT,
+};
+
+static const unsigned char char_classes[256] = {
+    CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x00
+    CC_OTHER, CC_SPACE, CC_NEWLINE, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x08
+    CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x10
+    CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x18
+    CC_SPACE, CC_OTHER, CC_QUOTE, CC_HASH, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x20
+    CC_LPAREN, CC_RPAREN, CC_OTHER, CC_OTHER, CC_OTHER, CC_MINUS, CC_OTHER, CC_OTHER, // 0x28
+    CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, CC_DIGIT, // 0x30
+    CC_DIGIT, CC_DIGIT, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, CC_OTHER, // 0x38
+    CC_OTHER, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_EXPONENT, CC_ALPHA, CC_ALPHA, // 0x40
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, // 0x48
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, // 0x50
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_LBRACK, CC_OTHER, CC_RBRACK, CC_OTHER, CC_UNDERSCORE, // 0x58
+    CC_OTHER, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_EXPONENT, CC_ALPHA, CC_ALPHA, // 0x60
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, // 0x68
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_ALPHA, // 0x70
+    CC_ALPHA, CC_ALPHA, CC_ALPHA, CC_LBRACE, CC_OTHER, CC_RBRACE, CC_OTHER, CC_OTHER, // 0x78
+    // 0x80 to 0xff are CC_OTHER, which is 0.
+};
+
+static inline int is_digit(unsigned char byte) {
+    return char_classes[byte] == CC_DIGIT;
+}
+
+static inline int is_number(unsigned char byte) {
+    return (unsigned)(char_classes[byte] - CC_DIGIT) <= CC_UNDERSCORE - CC_DIGIT;
+}
+
+static inline int is_identifier(unsigned char byte) {
+    return (unsigned)(char_classes[byte] - CC_ALPHA) <= CC_UNDERSCORE - CC_ALPHA;
+}
+
+enum TokenType {
+    TT_UNDEFN,
+    TT_IDENTI,
+    TT_WSPACE,
+    TT_NEWLIN,
+    TT_STRING,
+    TT_NUMBER,
+    TT_LPAREN,
+    TT_RPAREN,
+    TT_LBRACE,
+    TT_RBRACE,
+    TT_LBRACK,
+    TT_RBRACK,
+};
+
+static inline const char *token_type_to_string(enum TokenType token_type) {
+    switch (token_type) {
+        case TT_UNDEFN:
+            return "TT_UNDEFN";
+        case TT_IDENTI:
+            return "TT_IDENTI";
+        case TT_WSPACE:
+            return "TT_WSPACE";
+        case TT_NEWLIN:
+            return "TT_NEWLIN";
+        case TT_STRING:
+            return "TT_STRING";
+        case TT_NUMBER:
+            return "TT_NUMBER";
+        case TT_LPAREN:
+            return "TT_LPAREN";
+        case TT_RPAREN:
+            return "TT_RPAREN";
+        case TT_LBRACE:
+            return "TT_LBRACE";
+        case TT_RBRACE:
+            return "TT_RBRACE";
+        case TT_LBRACK:
+            return "TT_LBRACK";
+        case TT_RBRACK:
+            return "TT_RBRACK";
+    }
+    return NULL;
+}
+
+struct Token {
+    enum TokenType type;
+    size_t start, end;
+    size_t line, col;
+};
+
+// The source text is kept in memory as a whole.
+// Tokens refer to the source text by their start and end positions.
+struct Source {
+    const char *data;
+    size_t size;
+    size_t position;
+    size_t line, col;
+    enum TokenType last_type; // Of the last token other than whitespace, reported at EOF
+};
+
+static inline void source_init(struct Source *src, const char *data, size_t size) {
+    assert(src != NULL);
+    assert(data != NULL || size == 0);
+
+    src->data = data;
+    src->size = size;
+    src->position = 0;
+    src->line = 1;
+    src->col = 1;
+    src->last_type = TT_UNDEFN;
+}
+
+// The lexer is a state machine over the character classes. The class of the first byte
+// picks the state, which then consumes the rest of the token. With GCC and Clang the
+// state is picked through a table of label addresses, otherwise through a switch.
+static inline int token_next(struct Source *src, struct Token *token) {
+    assert(src != NULL);
+    assert(token != NULL);
+
+    const unsigned char *data = (const unsigned char*)src->data;
+    size_t size = src->size;
+    size_t position = src->position;
+    enum TokenType type;
+
+    // Carriage returns are ignored, they do not belong to any token.
+    while (position < size && data[position] == '\r') {
+        position += 1;
+    }
+
+    // Set the starting position of the token.
+    // This starts from 0 (just like an index).
+    token->start = position;
+    token->line = src->line;
+    token->col = src->col;
+
+    // At EOF the token has the type of the last token that was not whitespace,
+    // so that errors can tell what the source ended after.
+    if (position >= size) {
+        token->type = src->last_type;
+        token->end = position;
+        src->position = position;
+        return 0;
+    }
+
+#if defined(__GNUC__) && !defined(MYRON_NO_COMPUTED_GOTO)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+    // In the order of enum CharClass.
+    static void *const states[CC_COUNT] = {
+        &&Undefined,
+        &&Identifier,
+        &&Identifier,
+        &&Integer,
+        &&Undefined,
+        &&Whitespace,
+        &&Newline,
+        &&Comment,
+        &&String,
+        &&Minus,
+        &&LeftParen,
+        &&RightParen,
+        &&LeftBrace,
+        &&RightBrace,
+        &&LeftBracket,
+        &&RightBracket,
+    };
+    goto *states[char_classes[data[position++]]];
+#pragma GCC diagnostic pop
+#else
+    switch (char_classes[data[position++]]) {
+        case CC_ALPHA: goto Identifier;
+        case CC_EXPONENT: goto Identifier;
+        case CC_DIGIT: goto Integer;
+        case CC_SPACE: goto Whitespace;
+        case CC_NEWLINE: goto Newline;
+        case CC_HASH: goto Comment;
+        case CC_QUOTE: goto String;
+        case CC_MINUS: goto Minus;
+        case CC_LPAREN: goto LeftParen;
+        case CC_RPAREN: goto RightParen;
+        case CC_LBRACE: goto LeftBrace;
+        case CC_RBRACE: goto RightBrace;
+        case CC_LBRACK: goto LeftBracket;
+        case CC_RBRACK: goto RightBracket;
+        default: goto Undefined;
+    }
+#endif
+
+Identifier:
+    while (position < size && is_identifier(data[position])) {
+        position += 1;
+    }
+    type = TT_IDENTI;
+    goto Done;
+
+Minus:
+    // A minus sign is only valid in front of a number.
+    if (position >= size || !is_digit(data[position])) {
+        goto Undefined;
+    }
+    position += 1;
+    goto Integer;
+
+Integer:
+    // E.g. 1_000, followed by an optional fraction (1.5) and an optional exponent (2e-3).
+    while (position < size && is_number(data[position])) {
+        position += 1;
+    }
+    if (position + 1 < size && data[position] == '.' && is_digit(data[position + 1])) {
+        position += 2;
+        goto Fraction;
+    }
+    goto Exponent;
+
+Fraction:
+    while (position < size && is_number(data[position])) {
+        position += 1;
+    }
+    goto Exponent;
+
+Exponent:
+    type = TT_NUMBER;
+    if (position < size && char_classes[data[position]] == CC_EXPONENT) {
+        size_t next = position + 1;
+        if (next < size && (data[next] == '+' || data[next] == '-')) {
+            next += 1;
+        }
+        if (next < size && is_digit(data[next])) {
+            position = next + 1;
+            while (position < size && is_digit(data[position])) {
+                position += 1;
+            }
+        }
+    }
+    goto Done;
+
+Whitespace:
+    while (position < size && char_classes[data[position]] == CC_SPACE) {
+        position += 1;
+    }
+    if (position < size && data[position] == '#') {
+        goto Comment;
+    }
+    type = TT_WSPACE;
+    goto Done;
+
+Comment: {
+    // A comment runs until the end of the line and is read as whitespace.
+    const unsigned char *newline = (const unsigned char*)memchr(data + position, '\n', size - position);
+    position = newline != NULL ? (size_t)(newline - data) : size;
+    type = TT_WSPACE;
+    goto Done;
+}
+
+Newline:
+    token->type = TT_NEWLIN;
+    token->end = position;
+    src->position = position;
+    src->line += 1;
+    src->col = 1;
+    return 1;
+
+String:
+    for (;;) {
+        if (position >= size) {
+            // Unclosed string, the token ends at the end of the source.
+            type = TT_UNDEFN;
+            goto Done;
+        }
+        unsigned char byte = data[position++];
+        if (byte == '"') {
+            type = TT_STRING;
+            goto Done;
+        }
+        if (byte == '\\' && position < size) {
+            // The escaped byte can not end the string.
+            position += 1;
+        }
+    }
+
+LeftParen:
+    type = TT_LPAREN;
+    goto Done;
+RightParen:
+    type = TT_RPAREN;
+    goto Done;
+LeftBrace:
+    type = TT_LBRACE;
+    goto Done;
+RightBrace:
+    type = TT_RBRACE;
+    goto Done;
+LeftBracket:
+    type = TT_LBRACK;
+    goto Done;
+RightBracket:
+    type = TT_RBRACK;
+    goto Done;
+
+Undefined:
+    type = TT_UNDEFN;
+    goto Done;
+
+Done:
+    // Set the end point (exclusive index).
+    // The length of the token value is end - start.
+    token->type = type;
+    token->end = position;
+    src->position = position;
+    src->col += token->end - token->start;
+    if (type != TT_WSPACE) {
+        src->last_type = type;
+    }
+    return 1;
+}
+
+// STRING ESCAPES
+//
+// Strings use the escapes of JSON: \" \\ \/ \b \f \n \r \t and \uXXXX,
+// where a high surrogate must be followed by a low surrogate.
+
+// Reads 4 hex digits, returns 0 if there are not 4 of them.
+static inline int unescape_hex(const char *data, uint32_t *code) {
+    *code = 0;
+    for (int i = 0; i < 4; i += 1) {
+        char byte = data[i];
+        uint32_t digit;
+        if (byte >= '0' && byte <= '9') {
+            digit = byte - '0';
+        } else if (byte >= 'a' && byte <= 'f') {
+            digit = byte - 'a' + 10;
+        } else if (byte >= 'A' && byte <= 'F') {
+            digit = byte - 'A' + 10;
+        } else {
+            return 0;
+        }
+        *code = *code << 4 | digit;
+    }
+    return 1;
+}
+
+// Resolves the escapes of a string without its quotes, \u escapes become UTF-8.
+// The value is never longer than the escaped string, so out needs at most size bytes.
+// Without out the escapes are only validated. Returns 0 if an escape is invalid.
+static inline int string_unescape(const char *data, size_t size, char *out, size_t *out_size) {
+    size_t position = 0;
+    size_t length = 0;
+
+    for (;;) {
+        // Copy everything up to the next escape as is.
+        const char *escape = (const char*)memchr(data + position, '\\', size - position);
+        size_t end = escape != NULL ? (size_t)(escape - data) : size;
+        if (out != NULL) {
+            memcpy(out + length, data + position, end - position);
+        }
+        length += end - position;
+        position = end;
+
+        if (position == size) {
+            break;
+        }
+        if (position + 1 == size) {
+            return 0;
+        }
+
+        char byte;
+        switch (data[position + 1]) {
+            case '"': byte = '"'; break;
+            case '\\': byte = '\\'; break;
+            case '/': byte = '/'; break;
+            case 'b': byte = '\b'; break;
+            case 'f': byte = '\f'; break;
+            case 'n': byte = '\n'; break;
+            case 'r': byte = '\r'; break;
+            case 't': byte = '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (position + 6 > size || !unescape_hex(data + position + 2, &code)) {
+                    return 0;
+                }
+                position += 6;
+
+                if (code >= 0xD800 && code < 0xDC00) {
+                    uint32_t low;
+                    if (
+                        position + 6 > size || data[position] != '\\' || data[position + 1] != 'u' ||
+                        !unescape_hex(data + position + 2, &low) || low < 0xDC00 || low >= 0xE000
+                    ) {
+                        return 0;
+                    }
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    position += 6;
+                }
+
+                char bytes[4];
+                size_t count;
+                if (code < 0x80) {
+                    bytes[0] = (char)code;
+                    count = 1;
+                } else if (code < 0x800) {
+                    bytes[0] = (char)(0xC0 | (code >> 6));
+                    bytes[1] = (char)(0x80 | (code & 0x3F));
+                    count = 2;
+                } else if (code < 0x10000) {
+                    bytes[0] = (char)(0xE0 | (code >> 12));
+                    bytes[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    bytes[2] = (char)(0x80 | (code & 0x3F));
+                    count = 3;
+                } else {
+                    bytes[0] = (char)(0xF0 | (code >> 18));
+                    bytes[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+                    bytes[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+                    bytes[3] = (char)(0x80 | (code & 0x3F));
+                    count = 4;
+                }
+                if (out != NULL) {
+                    memcpy(out + length, bytes, count);
+                }
+                length += count;
+                continue;
+            }
+            default:
+                return 0;
+        }
+
+        if (out != NULL) {
+            out[length] = byte;
+        }
+        length += 1;
+        position += 2;
+    }
+
+    if (out_size != NULL) {
+        *out_size = length;
+    }
+    return 1;
+}
+
+#endif
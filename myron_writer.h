@@ -0,0 +1,773 @@
+// Header-only myron writer for C and C++.
+//
+// The output is collected into a growable buffer, which is written to the file
+// in bulk once it grows past MYRON_WRITER_FLUSH_SIZE. Without a file the output
+// stays in the buffer (writer.data, writer.size).
+//
+//     struct MyronWriter writer;
+//     myron_writer_init(&writer, stdout);
+//
+//     myron_write_key(&writer, "name");
+//     myron_write_string(&writer, "Alice");
+//
+//     const char *columns[] = {"name", "age"};
+//     myron_write_key(&writer, "people");
+//     myron_begin_table(&writer, columns, 2);
+//     myron_write_string(&writer, "Alice");
+//     myron_write_integer(&writer, 45);
+//     myron_end_table(&writer);
+//
+//     myron_writer_flush(&writer);
+//     myron_writer_free(&writer);
+//
+// A list whose elements are all records with the same keys is written as a
+// schema list automatically. Such a list is kept in the buffer until it ends,
+// use myron_begin_table to stream very large tables instead.
+
+#ifndef MYRON_WRITER_H
+#define MYRON_WRITER_H
+
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "myron_lexer.h"
+
+#define MYRON_WRITER_MAX_DEPTH 64
+#define MYRON_WRITER_FLUSH_SIZE (64 * 1024)
+
+enum MyronFrameType {
+    MYRON_FRAME_ROOT,
+    MYRON_FRAME_RECORD,
+    MYRON_FRAME_LIST,
+    MYRON_FRAME_TABLE,
+};
+
+struct MyronSpan {
+    size_t start, end;
+};
+
+struct MyronFrame {
+    enum MyronFrameType type;
+    size_t count; // Keys in records, values in lists and tables
+    size_t start; // Offset of the opening bracket
+    size_t value_start; // Offset of the current value in records
+    size_t column_count; // Tables
+    size_t indent; // Indentation of the rows in tables, 0 => the rows are on one line
+
+    // Lists collect the key and value spans of their first record element
+    // and the value spans of the rest, so that they can be rewritten as schema lists.
+    int is_homogeneous;
+    size_t key_count;
+    struct MyronSpan *spans;
+    size_t span_count;
+    size_t span_capacity;
+};
+
+struct MyronWriter {
+    char *data;
+    size_t size;
+    size_t capacity;
+    FILE *file; // NULL => the output stays in the buffer
+
+    struct MyronFrame frames[MYRON_WRITER_MAX_DEPTH];
+    size_t depth;
+    int is_after_key;
+    size_t candidate_count; // Open lists that can still become schema lists
+    int is_write_failed;
+
+    char *scratch;
+    size_t scratch_capacity;
+};
+
+// NUMBER FORMATTING
+
+static const char myron_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const double myron_powers_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// The powers of ten from 1e-7 to 1e15 that bound the fast float path.
+static const double myron_float_bounds[] = {
+    1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4,
+    1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+};
+
+// Writes the digits two at a time from the end, returns the number of bytes.
+static inline size_t myron_format_unsigned(char *buffer, uint64_t value) {
+    char digits[20];
+    size_t position = sizeof(digits);
+
+    while (value >= 100) {
+        const char *pair = myron_digit_pairs + (value % 100) * 2;
+        value /= 100;
+        digits[--position] = pair[1];
+        digits[--position] = pair[0];
+    }
+    if (value >= 10) {
+        const char *pair = myron_digit_pairs + value * 2;
+        digits[--position] = pair[1];
+        digits[--position] = pair[0];
+    } else {
+        digits[--position] = (char)('0' + value);
+    }
+
+    size_t size = sizeof(digits) - position;
+    memcpy(buffer, digits + position, size);
+    return size;
+}
+
+static inline size_t myron_format_integer(char *buffer, int64_t value) {
+    if (value < 0) {
+        buffer[0] = '-';
+        return 1 + myron_format_unsigned(buffer + 1, (uint64_t)0 - (uint64_t)value);
+    }
+    return myron_format_unsigned(buffer, (uint64_t)value);
+}
+
+// Writes the shortest decimal form of up to 15 significant digits that reads back
+// as exactly the same double, and falls back to 16 or 17 digits through snprintf otherwise.
+// The check is exact: the digits and the power of ten are both exactly representable,
+// so the division is a single correctly rounded operation, just like parsing.
+// The buffer must hold at least 32 bytes. Myron has no NaN or infinity, so
+// those are not written and 0 is returned.
+static inline size_t myron_format_float(char *buffer, double value) {
+    if (!isfinite(value)) {
+        return 0;
+    }
+
+    size_t size = 0;
+
+    if (signbit(value)) {
+        buffer[size++] = '-';
+        value = -value;
+    }
+
+    if (value == 0) {
+        memcpy(buffer + size, "0.0", 3);
+        return size + 3;
+    }
+
+    if (value >= 1e-7 && value < 1e15) {
+        // Find the decimal exponent, 10^exponent <= value < 10^(exponent + 1).
+        int exponent = -7;
+        while (exponent < 14 && value >= myron_float_bounds[exponent + 8]) {
+            exponent += 1;
+        }
+
+        int scale = 14 - exponent;
+        uint64_t digits = (uint64_t)(value * myron_powers_of_ten[scale] + 0.5);
+        if (digits >= 1000000000000000ull) {
+            digits /= 10;
+            scale -= 1;
+        }
+
+        if (scale >= 0 && (double)digits / myron_powers_of_ten[scale] == value) {
+            while (scale >= 8 && digits % 100000000 == 0) {
+                digits /= 100000000;
+                scale -= 8;
+            }
+            while (scale > 0 && digits % 10 == 0) {
+                digits /= 10;
+                scale -= 1;
+            }
+
+            char text[20];
+            size_t length = myron_format_unsigned(text, digits);
+
+            if (scale == 0) {
+                memcpy(buffer + size, text, length);
+                memcpy(buffer + size + length, ".0", 2);
+                return size + length + 2;
+            }
+            if ((size_t)scale < length) {
+                memcpy(buffer + size, text, length - scale);
+                buffer[size + length - scale] = '.';
+                memcpy(buffer + size + length - scale + 1, text + length - scale, scale);
+                return size + length + 1;
+            }
+
+            buffer[size++] = '0';
+            buffer[size++] = '.';
+            for (size_t i = length; i < (size_t)scale; i += 1) {
+                buffer[size++] = '0';
+            }
+            memcpy(buffer + size, text, length);
+            return size + length;
+        }
+    }
+
+    // Otherwise the shortest of 15, 16 and 17 significant digits that reads back as the
+    // same value. The text is read back in the same locale as it was written, and the
+    // decimal point of the locale is then replaced, since myron always uses a dot.
+    char text[40];
+    int length = 0;
+    for (int precision = 15; precision <= 17; precision += 1) {
+        length = snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (strtod(text, NULL) == value) {
+            break;
+        }
+    }
+    for (int i = 0; i < length; i += 1) {
+        char byte = text[i];
+        if ((byte >= '0' && byte <= '9') || byte == '-' || byte == '+' || byte == 'e') {
+            buffer[size++] = byte;
+            continue;
+        }
+        buffer[size++] = '.';
+        while (i + 1 < length && !(text[i + 1] >= '0' && text[i + 1] <= '9') && text[i + 1] != 'e') {
+            i += 1;
+        }
+    }
+
+    // Keep the value a float when it is read back.
+    if (!memchr(buffer, '.', size) && !memchr(buffer, 'e', size)) {
+        memcpy(buffer + size, ".0", 2);
+        size += 2;
+    }
+
+    return size;
+}
+
+// BUFFER
+
+static inline void myron_writer_init(struct MyronWriter *writer, FILE *file) {
+    assert(writer != NULL);
+
+    memset(writer, 0, sizeof(*writer));
+    writer->file = file;
+    writer->frames[0].type = MYRON_FRAME_ROOT;
+}
+
+static inline void myron_writer_reserve(struct MyronWriter *writer, size_t size) {
+    if (writer->size + size <= writer->capacity) {
+        return;
+    }
+
+    size_t capacity = writer->capacity ? writer->capacity : MYRON_WRITER_FLUSH_SIZE;
+    while (capacity < writer->size + size) {
+        capacity *= 2;
+    }
+
+    writer->data = (char*)realloc(writer->data, capacity);
+    assert(writer->data != NULL);
+    writer->capacity = capacity;
+}
+
+static inline void myron_writer_put(struct MyronWriter *writer, const char *data, size_t size) {
+    myron_writer_reserve(writer, size);
+    memcpy(writer->data + writer->size, data, size);
+    writer->size += size;
+}
+
+static inline void myron_writer_putc(struct MyronWriter *writer, char byte) {
+    myron_writer_reserve(writer, 1);
+    writer->data[writer->size++] = byte;
+}
+
+static inline void myron_writer_indent(struct MyronWriter *writer, size_t depth) {
+    myron_writer_reserve(writer, 1 + depth * 4);
+    writer->data[writer->size++] = '\n';
+    memset(writer->data + writer->size, ' ', depth * 4);
+    writer->size += depth * 4;
+}
+
+// Writes the buffered output to the file. The outermost list that can still become
+// a schema list is rewritten when it ends, so the output from its opening bracket on
+// stays in the buffer. Returns 0 if writing the file has failed at any point.
+static inline int myron_writer_flush(struct MyronWriter *writer) {
+    assert(writer != NULL);
+
+    if (writer->file == NULL) {
+        return 1;
+    }
+
+    size_t size = writer->size;
+    size_t depth = writer->depth + 1;
+    if (writer->candidate_count != 0) {
+        for (depth = 1; depth <= writer->depth; depth += 1) {
+            struct MyronFrame *frame = &writer->frames[depth];
+            if (frame->type == MYRON_FRAME_LIST && frame->is_homogeneous) {
+                size = frame->start;
+                break;
+            }
+        }
+    }
+    if (size == 0) {
+        return !writer->is_write_failed;
+    }
+
+    if (fwrite(writer->data, 1, size, writer->file) != size || fflush(writer->file) != 0) {
+        writer->is_write_failed = 1;
+    }
+    memmove(writer->data, writer->data + size, writer->size - size);
+    writer->size -= size;
+
+    // The frames from the outermost candidate on point into the rest of the buffer.
+    for (; depth <= writer->depth; depth += 1) {
+        struct MyronFrame *frame = &writer->frames[depth];
+        frame->start -= size;
+        frame->value_start -= size;
+        for (size_t i = 0; i < frame->span_count; i += 1) {
+            frame->spans[i].start -= size;
+            frame->spans[i].end -= size;
+        }
+    }
+
+    return !writer->is_write_failed;
+}
+
+// Only flushes when no list may still be rewritten, such a list has to stay
+// in the buffer until it ends anyway.
+static inline void myron_writer_flush_if_full(struct MyronWriter *writer) {
+    if (writer->size >= MYRON_WRITER_FLUSH_SIZE && writer->candidate_count == 0) {
+        myron_writer_flush(writer);
+    }
+}
+
+static inline void myron_writer_free(struct MyronWriter *writer) {
+    assert(writer != NULL);
+
+    for (size_t i = 0; i < MYRON_WRITER_MAX_DEPTH; i += 1) {
+        free(writer->frames[i].spans);
+    }
+    free(writer->data);
+    free(writer->scratch);
+
+    memset(writer, 0, sizeof(*writer));
+}
+
+// STRUCTURE
+
+static inline void myron_writer_push_span(struct MyronFrame *frame, size_t start, size_t end) {
+    if (frame->span_count == frame->span_capacity) {
+        frame->span_capacity = frame->span_capacity ? frame->span_capacity * 2 : 64;
+        frame->spans = (struct MyronSpan*)realloc(frame->spans, frame->span_capacity * sizeof(struct MyronSpan));
+        assert(frame->spans != NULL);
+    }
+    frame->spans[frame->span_count].start = start;
+    frame->spans[frame->span_count].end = end;
+    frame->span_count += 1;
+}
+
+static inline void myron_writer_reject_schema(struct MyronWriter *writer, struct MyronFrame *frame) {
+    if (frame->is_homogeneous) {
+        frame->is_homogeneous = 0;
+        writer->candidate_count -= 1;
+    }
+}
+
+// The parent list of the current record, if that list can still become a schema list.
+static inline struct MyronFrame *myron_writer_candidate(struct MyronWriter *writer) {
+    if (writer->depth == 0) {
+        return NULL;
+    }
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+    if (frame->type != MYRON_FRAME_RECORD) {
+        return NULL;
+    }
+    struct MyronFrame *parent = frame - 1;
+    return parent->type == MYRON_FRAME_LIST && parent->is_homogeneous ? parent : NULL;
+}
+
+// Writes the separator in front of a value.
+static inline void myron_writer_begin_value(struct MyronWriter *writer, int is_record) {
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+
+    switch (frame->type) {
+        case MYRON_FRAME_ROOT:
+        case MYRON_FRAME_RECORD:
+            assert(writer->is_after_key);
+            myron_writer_putc(writer, ' ');
+            frame->value_start = writer->size;
+            break;
+        case MYRON_FRAME_LIST:
+            if (frame->count != 0) {
+                myron_writer_putc(writer, ' ');
+            }
+            if (!is_record) {
+                myron_writer_reject_schema(writer, frame);
+            }
+            frame->count += 1;
+            break;
+        case MYRON_FRAME_TABLE:
+            if (frame->count % frame->column_count == 0 && frame->indent != 0) {
+                myron_writer_indent(writer, frame->indent);
+            } else if (frame->count != 0) {
+                myron_writer_putc(writer, ' ');
+            }
+            frame->count += 1;
+            break;
+    }
+}
+
+static inline void myron_writer_end_value(struct MyronWriter *writer) {
+    struct MyronFrame *candidate = myron_writer_candidate(writer);
+    if (candidate != NULL) {
+        myron_writer_push_span(candidate, writer->frames[writer->depth].value_start, writer->size);
+    }
+
+    writer->is_after_key = 0;
+    myron_writer_flush_if_full(writer);
+}
+
+static inline struct MyronFrame *myron_writer_push_frame(struct MyronWriter *writer, enum MyronFrameType type) {
+    assert(writer->depth + 1 < MYRON_WRITER_MAX_DEPTH);
+
+    writer->depth += 1;
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+    frame->type = type;
+    frame->count = 0;
+    frame->start = writer->size;
+    frame->value_start = writer->size;
+    frame->is_homogeneous = 0;
+    frame->key_count = 0;
+    frame->span_count = 0;
+
+    return frame;
+}
+
+// Keys must be identifiers: a letter followed by letters, digits or underscores.
+static inline int myron_is_key(const char *key, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    unsigned char first = (unsigned char)key[0];
+    if (char_classes[first] != CC_ALPHA && char_classes[first] != CC_EXPONENT) {
+        return 0;
+    }
+    for (size_t i = 1; i < size; i += 1) {
+        if (!is_identifier((unsigned char)key[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Returns 0 and writes nothing when the key is not an identifier, see myron_is_key.
+static inline int myron_write_key_n(struct MyronWriter *writer, const char *key, size_t size) {
+    assert(writer != NULL);
+    assert(key != NULL || size == 0);
+
+    if (!myron_is_key(key, size)) {
+        return 0;
+    }
+
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+    assert(frame->type == MYRON_FRAME_ROOT || frame->type == MYRON_FRAME_RECORD);
+    assert(!writer->is_after_key);
+
+    if (frame->count != 0) {
+        myron_writer_putc(writer, frame->type == MYRON_FRAME_ROOT ? '\n' : ' ');
+    }
+
+    size_t start = writer->size;
+    myron_writer_put(writer, key, size);
+    frame->count += 1;
+    writer->is_after_key = 1;
+
+    // The keys of the first record make up the schema, the rest must match them.
+    struct MyronFrame *candidate = myron_writer_candidate(writer);
+    if (candidate == NULL) {
+        return 1;
+    }
+    if (candidate->count == 1) {
+        myron_writer_push_span(candidate, start, writer->size);
+        return 1;
+    }
+
+    size_t index = frame->count - 1;
+    if (index >= candidate->key_count) {
+        myron_writer_reject_schema(writer, candidate);
+        return 1;
+    }
+    struct MyronSpan first = candidate->spans[index * 2];
+    if (first.end - first.start != size || memcmp(writer->data + first.start, key, size)) {
+        myron_writer_reject_schema(writer, candidate);
+    }
+    return 1;
+}
+
+static inline int myron_write_key(struct MyronWriter *writer, const char *key) {
+    assert(key != NULL);
+    return myron_write_key_n(writer, key, strlen(key));
+}
+
+static inline void myron_begin_record(struct MyronWriter *writer) {
+    assert(writer != NULL);
+
+    myron_writer_begin_value(writer, 1);
+    myron_writer_push_frame(writer, MYRON_FRAME_RECORD);
+    myron_writer_putc(writer, '{');
+    writer->is_after_key = 0;
+}
+
+static inline void myron_end_record(struct MyronWriter *writer) {
+    assert(writer != NULL);
+    assert(writer->frames[writer->depth].type == MYRON_FRAME_RECORD);
+    assert(!writer->is_after_key);
+
+    myron_writer_putc(writer, '}');
+
+    // Every record of a schema list must have the same keys in the same order.
+    // The keys themselves were already compared as they were written.
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+    struct MyronFrame *candidate = myron_writer_candidate(writer);
+
+    if (candidate != NULL) {
+        if (candidate->count == 1) {
+            candidate->key_count = frame->count;
+        }
+        if (frame->count != candidate->key_count || frame->count == 0) {
+            myron_writer_reject_schema(writer, candidate);
+        }
+    }
+
+    writer->depth -= 1;
+    myron_writer_end_value(writer);
+}
+
+static inline void myron_begin_list(struct MyronWriter *writer) {
+    assert(writer != NULL);
+
+    myron_writer_begin_value(writer, 0);
+    struct MyronFrame *frame = myron_writer_push_frame(writer, MYRON_FRAME_LIST);
+    myron_writer_putc(writer, '[');
+
+    frame->is_homogeneous = 1;
+    writer->candidate_count += 1;
+}
+
+static inline void myron_writer_scratch_put(struct MyronWriter *writer, size_t *size, const char *data, size_t data_size) {
+    if (*size + data_size > writer->scratch_capacity) {
+        size_t capacity = writer->scratch_capacity ? writer->scratch_capacity : MYRON_WRITER_FLUSH_SIZE;
+        while (capacity < *size + data_size) {
+            capacity *= 2;
+        }
+        writer->scratch = (char*)realloc(writer->scratch, capacity);
+        assert(writer->scratch != NULL);
+        writer->scratch_capacity = capacity;
+    }
+    memcpy(writer->scratch + *size, data, data_size);
+    *size += data_size;
+}
+
+static inline void myron_writer_scratch_indent(struct MyronWriter *writer, size_t *size, size_t depth) {
+    myron_writer_scratch_put(writer, size, "\n", 1);
+    for (size_t i = 0; i < depth; i += 1) {
+        myron_writer_scratch_put(writer, size, "    ", 4);
+    }
+}
+
+// The rows of schema lists and tables go one level deeper than the line they start on.
+// Inside a list that can still become a schema list they are written on one line,
+// since the rows of that list may yet be moved onto lines of their own.
+static inline size_t myron_writer_row_indent(struct MyronWriter *writer) {
+    size_t indent = 1;
+    for (size_t i = 1; i < writer->depth; i += 1) {
+        struct MyronFrame *frame = &writer->frames[i];
+        if (frame->type == MYRON_FRAME_LIST && frame->is_homogeneous) {
+            return 0;
+        }
+        if (frame->type == MYRON_FRAME_TABLE) {
+            indent += 1;
+        }
+    }
+    return indent;
+}
+
+// Rewrites the records of the list as the rows of a schema list.
+// The schema list is built in the scratch buffer, and then copied over the list.
+static inline void myron_writer_write_schema(struct MyronWriter *writer, struct MyronFrame *frame) {
+    size_t size = 0;
+    size_t key_count = frame->key_count;
+    size_t indent = myron_writer_row_indent(writer);
+
+    myron_writer_scratch_put(writer, &size, "(", 1);
+    for (size_t i = 0; i < key_count; i += 1) {
+        struct MyronSpan key = frame->spans[i * 2];
+        if (i != 0) {
+            myron_writer_scratch_put(writer, &size, " ", 1);
+        }
+        myron_writer_scratch_put(writer, &size, writer->data + key.start, key.end - key.start);
+    }
+    myron_writer_scratch_put(writer, &size, ") [", 3);
+
+    // The first row has its keys in between the values, the other rows only have values.
+    size_t value_count = frame->span_count - key_count;
+    for (size_t i = 0; i < value_count; i += 1) {
+        struct MyronSpan value = frame->spans[i < key_count ? i * 2 + 1 : i + key_count];
+        if (i % key_count == 0 && indent != 0) {
+            myron_writer_scratch_indent(writer, &size, indent);
+        } else if (i != 0) {
+            myron_writer_scratch_put(writer, &size, " ", 1);
+        }
+        myron_writer_scratch_put(writer, &size, writer->data + value.start, value.end - value.start);
+    }
+
+    if (indent != 0) {
+        myron_writer_scratch_indent(writer, &size, indent - 1);
+    }
+    myron_writer_scratch_put(writer, &size, "]", 1);
+
+    writer->size = frame->start;
+    myron_writer_put(writer, writer->scratch, size);
+}
+
+static inline void myron_end_list(struct MyronWriter *writer) {
+    assert(writer != NULL);
+    assert(writer->frames[writer->depth].type == MYRON_FRAME_LIST);
+
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+
+    if (frame->is_homogeneous && frame->count != 0) {
+        myron_writer_write_schema(writer, frame);
+    } else {
+        myron_writer_putc(writer, ']');
+    }
+
+    myron_writer_reject_schema(writer, frame);
+    writer->depth -= 1;
+    myron_writer_end_value(writer);
+}
+
+// Starts a schema list with the columns. The values of the rows follow,
+// column_count values per row. Rows are not buffered, so any number of them can be written.
+// Returns 0 and writes nothing when a column is not a key, see myron_is_key.
+static inline int myron_begin_table(struct MyronWriter *writer, const char *const *columns, size_t column_count) {
+    assert(writer != NULL);
+    assert(columns != NULL);
+    assert(column_count > 0);
+
+    for (size_t i = 0; i < column_count; i += 1) {
+        if (!myron_is_key(columns[i], strlen(columns[i]))) {
+            return 0;
+        }
+    }
+
+    myron_writer_begin_value(writer, 0);
+    struct MyronFrame *frame = myron_writer_push_frame(writer, MYRON_FRAME_TABLE);
+    frame->column_count = column_count;
+    frame->indent = myron_writer_row_indent(writer);
+
+    myron_writer_putc(writer, '(');
+    for (size_t i = 0; i < column_count; i += 1) {
+        if (i != 0) {
+            myron_writer_putc(writer, ' ');
+        }
+        myron_writer_put(writer, columns[i], strlen(columns[i]));
+    }
+    myron_writer_put(writer, ") [", 3);
+    return 1;
+}
+
+static inline void myron_end_table(struct MyronWriter *writer) {
+    assert(writer != NULL);
+
+    struct MyronFrame *frame = &writer->frames[writer->depth];
+    assert(frame->type == MYRON_FRAME_TABLE);
+    assert(frame->count % frame->column_count == 0);
+
+    if (frame->count != 0 && frame->indent != 0) {
+        myron_writer_indent(writer, frame->indent - 1);
+    }
+    myron_writer_putc(writer, ']');
+
+    writer->depth -= 1;
+    myron_writer_end_value(writer);
+}
+
+// VALUES
+
+static inline void myron_write_integer(struct MyronWriter *writer, int64_t value) {
+    assert(writer != NULL);
+
+    myron_writer_begin_value(writer, 0);
+    myron_writer_reserve(writer, 20);
+    writer->size += myron_format_integer(writer->data + writer->size, value);
+    myron_writer_end_value(writer);
+}
+
+// Returns 0 and writes nothing when the value is NaN or infinite, so that
+// the caller can write some other value in its place.
+static inline int myron_write_float(struct MyronWriter *writer, double value) {
+    assert(writer != NULL);
+
+    if (!isfinite(value)) {
+        return 0;
+    }
+
+    myron_writer_begin_value(writer, 0);
+    myron_writer_reserve(writer, 32);
+    writer->size += myron_format_float(writer->data + writer->size, value);
+    myron_writer_end_value(writer);
+    return 1;
+}
+
+static inline void myron_write_boolean(struct MyronWriter *writer, int value) {
+    assert(writer != NULL);
+
+    myron_writer_begin_value(writer, 0);
+    if (value) {
+        myron_writer_put(writer, "true", 4);
+    } else {
+        myron_writer_put(writer, "false", 5);
+    }
+    myron_writer_end_value(writer);
+}
+
+// Quotes, backslashes and control characters are escaped like in JSON.
+static inline void myron_write_string_n(struct MyronWriter *writer, const char *value, size_t size) {
+    assert(writer != NULL);
+    assert(value != NULL || size == 0);
+
+    myron_writer_begin_value(writer, 0);
+
+    // Every byte takes at most 6 bytes escaped.
+    myron_writer_reserve(writer, size * 6 + 2);
+    char *output = writer->data + writer->size;
+    *output++ = '"';
+
+    for (size_t i = 0; i < size; i += 1) {
+        unsigned char byte = (unsigned char)value[i];
+        if (byte >= 0x20 && byte != '"' && byte != '\\') {
+            *output++ = (char)byte;
+            continue;
+        }
+        *output++ = '\\';
+        switch (byte) {
+            case '"': *output++ = '"'; break;
+            case '\\': *output++ = '\\'; break;
+            case '\n': *output++ = 'n'; break;
+            case '\r': *output++ = 'r'; break;
+            case '\t': *output++ = 't'; break;
+            default:
+                *output++ = 'u';
+                *output++ = '0';
+                *output++ = '0';
+                *output++ = "0123456789abcdef"[byte >> 4];
+                *output++ = "0123456789abcdef"[byte & 15];
+                break;
+        }
+    }
+
+    *output++ = '"';
+    writer->size = output - writer->data;
+
+    myron_writer_end_value(writer);
+}
+
+static inline void myron_write_string(struct MyronWriter *writer, const char *value) {
+    assert(value != NULL);
+    myron_write_string_n(writer, value, strlen(value));
+}
+
+#endif
@@ -0,0 +1,332 @@
+// Builds myron.hpp and myron_writer.h and checks that values survive a round trip.
+// The generated document is written to the path in the first argument, so that
+// the Makefile can compare the pipelined conversion with the direct one.
+
+#include "myron.hpp"
+#include "myron_columns.h"
+
+#include <cmath>
+#include <cstdio>
+
+static int failure_count = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+            failure_count += 1; \
+        } \
+    } while (0)
+
+struct Address {
+    std::string country;
+    std::string city;
+};
+MYRON_FIELDS(Address, country, city)
+
+struct Person {
+    std::string name;
+    int64_t age = 0;
+    bool is_active = false;
+    double score = 0;
+    Address address;
+    std::vector<std::string> tags;
+};
+MYRON_FIELDS(Person, name, age, is_active, score, address, tags)
+
+struct Document {
+    std::string title;
+    std::vector<Person> people;
+    std::vector<int> numbers;
+    std::vector<Address> empty;
+};
+MYRON_FIELDS(Document, title, people, numbers, empty)
+
+static bool operator==(const Address &a, const Address &b) {
+    return a.country == b.country && a.city == b.city;
+}
+
+static bool operator==(const Person &a, const Person &b) {
+    return (
+        a.name == b.name && a.age == b.age && a.is_active == b.is_active &&
+        a.score == b.score && a.address == b.address && a.tags == b.tags
+    );
+}
+
+static bool fails(std::string_view text) {
+    try {
+        myron::parse<Document>(text);
+    } catch (const myron::ParseError &) {
+        return true;
+    }
+    return false;
+}
+
+static void test_round_trip() {
+    Document document;
+    document.title = "quote \" backslash \\ newline \n tab \t control \x01 utf-8 \xc3\xa9";
+    document.numbers = {0, -1, 2147483647, -2147483647 - 1};
+    for (int i = 0; i < 100; i += 1) {
+        Person person;
+        person.name = "Person " + std::to_string(i);
+        person.age = i * 1000003 - 50000000;
+        person.is_active = i % 3 == 0;
+        person.score = i * 0.1 - 3.7;
+        person.address = {"FI", i % 2 ? "Helsinki" : "Tampere"};
+        person.tags.assign(i % 4, "tag");
+        document.people.push_back(person);
+    }
+
+    std::string text = myron::to_string(document);
+    CHECK(text.find("people (name age is_active score address tags) [") != std::string::npos);
+
+    Document copy = myron::parse<Document>(text);
+    CHECK(copy.title == document.title);
+    CHECK(copy.people == document.people);
+    CHECK(copy.numbers == document.numbers);
+    CHECK(copy.empty.empty());
+}
+
+static void test_parse() {
+    Document document = myron::parse<Document>(
+        "# A comment\n"
+        "title \"\\u00e9\\ud83d\\ude00\"  # Trailing comment\n"
+        "numbers [1_000 -2]\n"
+        "unknown {a [1 2] b (x y) [1 2]}\n"
+    );
+    CHECK(document.title == "\xc3\xa9\xf0\x9f\x98\x80");
+    CHECK(document.numbers == std::vector<int>({1000, -2}));
+
+    Document filled = myron::parse<Document>("numbers [1] numbers [2 3] title \"a\" title \"b\"");
+    CHECK(filled.numbers == std::vector<int>({2, 3}));
+    CHECK(filled.title == "b");
+    myron::parse("numbers [4] people (name) [\"Eve\"]", filled);
+    CHECK(filled.numbers == std::vector<int>({4}));
+    CHECK(filled.people.size() == 1);
+    myron::parse("people (name) [\"Eve\" \"Mallory\"]", filled);
+    CHECK(filled.people.size() == 2);
+
+    CHECK(fails("title 1"));
+    CHECK(fails("unknown \"\\q\""));
+    CHECK(fails("unknown [{a \"\\u12\"}]"));
+    CHECK(fails("title \"\\q\""));
+    CHECK(fails("title \"\\u12\""));
+    CHECK(fails("numbers [1.5]"));
+    CHECK(fails("numbers [1"));
+}
+
+static void test_writer() {
+    myron::Writer writer;
+    const char *columns[] = {"x", "y"};
+
+    writer.key("table");
+    writer.begin_table({columns[0], columns[1]});
+    writer.value(1);
+    writer.value(-2.5);
+    writer.end_table();
+    writer.key("mixed");
+    writer.begin_list();
+    writer.begin_record();
+    writer.key("x");
+    writer.value(1);
+    writer.end_record();
+    writer.value("text");
+    writer.end_list();
+
+    CHECK(writer.str() == "table (x y) [\n    1 -2.5\n]\nmixed [{x 1} \"text\"]");
+
+    // Schema lists in the rows of another schema list stay on one line,
+    // and the rows of the others are indented from the line they start on.
+    myron::Writer nested;
+    nested.key("a");
+    nested.begin_list();
+    for (int i = 0; i < 2; i += 1) {
+        nested.begin_record();
+        nested.key("x");
+        nested.value(i);
+        nested.key("y");
+        nested.begin_list();
+        for (int j = 0; j < 2; j += 1) {
+            nested.begin_record();
+            nested.key("p");
+            nested.value(j);
+            nested.end_record();
+        }
+        nested.end_list();
+        nested.end_record();
+    }
+    nested.end_list();
+    nested.key("b");
+    nested.begin_record();
+    nested.key("t");
+    nested.begin_table({columns[0]});
+    nested.value(1);
+    nested.end_table();
+    nested.end_record();
+
+    CHECK(nested.str() == "a (x y) [\n    0 (p) [0 1]\n    1 (p) [0 1]\n]\nb {t (x) [\n    1\n]}");
+
+    char buffer[64];
+    CHECK(std::string_view(buffer, myron_format_float(buffer, 0.1)) == "0.1");
+    CHECK(std::string_view(buffer, myron_format_float(buffer, 1e300)) == "1e+300");
+    CHECK(std::string_view(buffer, myron_format_float(buffer, 1e15)) == "1e+15");
+    CHECK(std::string_view(buffer, myron_format_float(buffer, -2.5e-9)) == "-2.5e-09");
+    CHECK(std::string_view(buffer, myron_format_float(buffer, 1152921504606846976.0)) == "1.152921504606847e+18");
+    CHECK(std::string_view(buffer, myron_format_float(buffer, 1234567890123456.8)) == "1234567890123456.8");
+    CHECK(std::string_view(buffer, myron_format_integer(buffer, INT64_MIN)) == "-9223372036854775808");
+    CHECK(myron_format_float(buffer, NAN) == 0);
+
+    myron::Writer key_writer;
+    CHECK(myron_write_key(key_writer.get(), "bad key") == 0);
+    CHECK(myron_write_key(key_writer.get(), "1st") == 0);
+    CHECK(myron_write_key(key_writer.get(), "") == 0);
+    const char *bad_columns[] = {"x", "_y"};
+    CHECK(myron_begin_table(key_writer.get(), bad_columns, 2) == 0);
+    CHECK(myron_write_key(key_writer.get(), "good_key2") == 1);
+    myron_write_integer(key_writer.get(), 1);
+    CHECK(key_writer.str() == "good_key2 1");
+
+    myron::Writer nan_writer;
+    bool is_thrown = false;
+    nan_writer.key("x");
+    try {
+        nan_writer.value(-INFINITY);
+    } catch (const myron::WriteError &) {
+        is_thrown = true;
+    }
+    nan_writer.value(0.5);
+    CHECK(is_thrown);
+    CHECK(nan_writer.str() == "x 0.5");
+}
+
+// Flushing in the middle of a list that becomes a schema list gives the same output.
+static void test_flush() {
+    FILE *file = tmpfile();
+    CHECK(file != nullptr);
+    if (file == nullptr) {
+        return;
+    }
+
+    std::string expected;
+    {
+        myron::Writer buffered;
+        myron::Writer writer(file);
+        for (myron::Writer *w : {&buffered, &writer}) {
+            w->key("title");
+            w->value("flush");
+            w->key("outer");
+            w->begin_record();
+            w->key("people");
+            w->begin_list();
+            for (int i = 0; i < 3; i += 1) {
+                w->begin_record();
+                w->key("id");
+                w->value(i);
+                w->key("tags");
+                w->begin_list();
+                w->value("a");
+                w->flush();
+                w->end_list();
+                w->end_record();
+                w->flush();
+            }
+            w->end_list();
+            w->end_record();
+            w->flush();
+        }
+        expected = std::string(buffered.str());
+    }
+
+    std::string output(expected.size() + 1, '\0');
+    rewind(file);
+    output.resize(fread(output.data(), 1, output.size(), file));
+    fclose(file);
+
+    CHECK(expected.find("people (id tags) [") != std::string::npos);
+    CHECK(output == expected);
+}
+
+// Writes a larger document with the C writer.
+static void write_document(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == nullptr) {
+        fprintf(stderr, "[FAIL] Failed to open %s\n", path);
+        failure_count += 1;
+        return;
+    }
+
+    MyronWriter writer;
+    myron_writer_init(&writer, file);
+
+    myron_write_key(&writer, "people");
+    myron_begin_list(&writer);
+    for (int i = 0; i < 20000; i += 1) {
+        myron_begin_record(&writer);
+        myron_write_key(&writer, "id");
+        myron_write_integer(&writer, i);
+        myron_write_key(&writer, "name");
+        myron_write_string(&writer, i % 2 ? "Alice" : "Bob \"the builder\"");
+        myron_write_key(&writer, "score");
+        myron_write_float(&writer, i % 3 == 0 ? i / 10.0 : i / 8.0);
+        myron_end_record(&writer);
+    }
+    myron_end_list(&writer);
+
+    myron_writer_flush(&writer);
+    myron_writer_free(&writer);
+    fclose(file);
+}
+
+// Reads the columns file of the document from write_document back.
+static void test_columns(const char *path) {
+    ColumnFile file = {};
+    ColumnFileError error = {};
+    CHECK(column_file_open(path, &file, &error) == COLUMN_FILE_ERROR_NONE);
+    if (error.code != COLUMN_FILE_ERROR_NONE) {
+        return;
+    }
+
+    const ColumnFileTable *people = column_file_find_table(&file, "people");
+    const ColumnFileColumn *id = column_file_find_column(&file, people, "id");
+    const ColumnFileColumn *name = column_file_find_column(&file, people, "name");
+    const ColumnFileColumn *score = column_file_find_column(&file, people, "score");
+    CHECK(people != nullptr && people->row_count == 20000);
+    CHECK(column_file_find_column(&file, people, "missing") == nullptr);
+    CHECK(id != nullptr && id->type == COLUMN_TYPE_INTEGER);
+    CHECK(name != nullptr && name->type == COLUMN_TYPE_STRING);
+    CHECK(score != nullptr && score->type == COLUMN_TYPE_FLOAT);
+
+    if (people != nullptr && id != nullptr && name != nullptr && score != nullptr) {
+        const int64_t *ids = column_file_integers(&file, id);
+        CHECK(ids[0] == 0 && ids[19999] == 19999);
+        CHECK(column_file_floats(&file, score)[8] == 1.0);
+
+        size_t size;
+        const char *value = column_file_string(&file, name, 0, &size);
+        CHECK(std::string_view(value, size) == "Bob \"the builder\"");
+    }
+
+    column_file_close(&file);
+}
+
+int main(int argc, char **argv) {
+    // With --columns, only the columns file that myron wrote for the document is checked.
+    if (argc > 2 && std::string_view(argv[1]) == "--columns") {
+        test_columns(argv[2]);
+    } else {
+        test_round_trip();
+        test_parse();
+        test_writer();
+        test_flush();
+
+        if (argc > 1) {
+            write_document(argv[1]);
+        }
+    }
+
+    if (failure_count != 0) {
+        fprintf(stderr, "[FAIL] %d checks failed\n", failure_count);
+        return 1;
+    }
+    return 0;
+}